@@ -29,6 +29,20 @@ public:
      * @param collision_normal The normal of the collision (out parameter).
     */
     void resolveCollision(const AABB &other, sf::Vector2f &penetration_depth, sf::Vector2f &collision_normal);
+    /**
+     * @brief Sweep this AABB towards another AABB.
+     * Finds the time of impact if this AABB were moved by an offset, i.e. how
+     * far along the offset this AABB can move before it touches the other AABB.
+     * Unlike resolveCollision(), this works no matter how large the offset is,
+     * and even if the other AABB has zero width or height.
+     * @param other The other AABB.
+     * @param offset The offset this AABB is moved by.
+     * @param collision_normal The normal of the surface that was hit (out parameter).
+     * This is (0, 0) if nothing was hit.
+     * @return The time of impact in the range [0, 1], where 1 means nothing was hit.
+     * If the AABBs are already overlapping, or the offset is zero, nothing is hit.
+    */
+    float sweep(const AABB &other, const sf::Vector2f &offset, sf::Vector2f &collision_normal) const;
     /**
      * @brief Move the AABB by an offset.
      * @param offset The offset to move the AABB by.
@@ -45,6 +59,12 @@ public:
      * @note This is only for debugging purposes.
     */
     virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
+private:
+    /**
+     * @brief How far the AABBs can overlap and still be considered touching.
+     * This makes up for the rounding errors after moving an AABB into contact.
+    */
+    static constexpr float SWEEP_EPSILON = 1e-4f;
 };
 
 } // namespace engine
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <map>
+#include <string>
+#include <cstdint>
+
+#include "resources/animation_clip.hpp"
+#include "resources/game_registry.hpp"
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class AnimationTable
+ * @brief The animation clip of an entity for each state and facing.
+ *
+ * The clips are looked up by their animation keys (see Entity::IDLE_DOWN etc.)
+ * once, when the table is created, so picking the clip to play while the game
+ * is running is an index into an array rather than a string lookup. The same
+ * table is shared by an Entity and by every lightweight entity of a kind, see
+ * World::spawnEntities().
+*/
+class AnimationTable {
+public:
+    /**
+     * @brief What the entity is doing, which picks the animation.
+    */
+    enum State : uint8_t {
+        IDLE,
+        WALK,
+        ATTACK,
+        STATE_COUNT
+    };
+    /**
+     * @brief The direction the entity is facing.
+    */
+    enum Facing : uint8_t {
+        DOWN,
+        UP,
+        LEFT,
+        RIGHT,
+        FACING_COUNT
+    };
+    /**
+     * @struct Slot
+     * @brief The clip to play for a state and facing, and whether to flip it.
+    */
+    struct Slot {
+        resources::AnimationClipId clip = resources::AnimationClip::INVALID_ID;
+        bool flip = false;
+    };
+    /**
+     * @brief Construct an empty table, without any clips.
+    */
+    AnimationTable() = default;
+    /**
+     * @brief Construct the table of an entity from its animation keys.
+     * Left and right share a clip, which is flipped when facing left.
+     * @param data The data of the entity.
+    */
+    explicit AnimationTable(const resources::GameRegistry::EntityData &data);
+    /**
+     * @brief Get the slot of a state and facing.
+     * The clip is AnimationClip::INVALID_ID if the entity doesn't have one for it.
+    */
+    inline const Slot& get(State state, Facing facing) const { return slots[state][facing]; }
+    /**
+     * @brief Get the slot to play for a movement.
+     * Walking faces the direction of movement, standing still keeps facing the
+     * way the entity last moved.
+     * @param direction The direction of movement, or (0, 0) if standing still.
+     * @param previous_direction The direction the entity last moved in.
+    */
+    const Slot& getMovement(const sf::Vector2f &direction, const sf::Vector2f &previous_direction) const;
+    /**
+     * @brief Get the facing of a direction.
+     * Vertical movement wins over horizontal movement, and standing still faces down.
+    */
+    static Facing getFacing(const sf::Vector2f &direction);
+private:
+    std::array<std::array<Slot, FACING_COUNT>, STATE_COUNT> slots;
+    /**
+     * @brief Fill the slots of a state from its animation keys.
+     * @param animations The animation clips of the entity, see GameRegistry::EntityData.
+     * @param registry_name The registry name of the entity, which prefixes the keys.
+     * @param state The state to fill.
+     * @param down, up, left_right The animation keys (without the registry name).
+    */
+    void setAnimations(const std::map<std::string, resources::AnimationClipId> &animations, const std::string &registry_name,
+        State state, const char *down, const char *up, const char *left_right);
+};
+
+} // namespace engine
+} // namespace rpg
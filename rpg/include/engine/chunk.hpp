@@ -0,0 +1,146 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <bitset>
+#include <vector>
+
+#include "engine/constants.hpp"
+#include "engine/game_object.hpp"
+#include "engine/object_pool.hpp"
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class Chunk
+ * @brief A square section of the world, CHUNK_SIZE x CHUNK_SIZE tiles large.
+ * 
+ * A chunk keeps track of which of its tiles are solid, i.e. which tiles can't
+ * be walked on. This is stored as one bit per tile, so checking the solidity
+ * of a tile never has to look at the tile itself.
+ * 
+ * A chunk also owns the static objects (rocks, bushes etc.) whose top left
+ * corner is inside it. Static objects never move, so once a chunk is baked
+ * their AABBs and vertices are stored in flat arrays sorted by y position.
+ * Collision checks can stop as soon as they reach an object below the area
+ * they're checking, and the vertices are already in the order they're drawn in.
+ * 
+ * The static objects are allocated from a pool owned by the chunk, so all of
+ * them can be freed at once when the chunk is evicted.
+*/
+class Chunk {
+public:
+    /**
+     * @brief The number of tiles in a chunk.
+    */
+    static constexpr int TILE_COUNT = constants::CHUNK_SIZE * constants::CHUNK_SIZE;
+    /**
+     * @brief Construct a new Chunk object.
+     * All tiles in the chunk start out as not solid.
+     * @param position The position of the chunk (in chunks, not tiles).
+    */
+    Chunk(const sf::Vector2i &position);
+    /**
+     * @brief Check if a tile is solid.
+     * @param x The x coordinate of the tile within the chunk.
+     * @param y The y coordinate of the tile within the chunk.
+    */
+    inline bool isSolid(int x, int y) const { return solid[x + y * constants::CHUNK_SIZE]; }
+    /**
+     * @brief Set whether or not a tile is solid.
+     * @param x The x coordinate of the tile within the chunk.
+     * @param y The y coordinate of the tile within the chunk.
+     * @param is_solid Whether or not the tile is solid.
+    */
+    inline void setSolid(int x, int y, bool is_solid) { solid[x + y * constants::CHUNK_SIZE] = is_solid; }
+    /**
+     * @brief Check if any of the tiles in the chunk are solid.
+    */
+    inline bool hasSolidTiles() const { return solid.any(); }
+    /**
+     * @brief Get the position of the chunk (in chunks, not tiles).
+    */
+    inline const sf::Vector2i& getPosition() const { return position; }
+    /**
+     * @brief Create a static object in the chunk.
+     * The object isn't part of the baked data until the chunk is baked again.
+     * @param position The position of the object.
+     * @param data The data of the object.
+     * @return The object, which lives until the static objects are cleared.
+    */
+    GameObject& createStaticObject(const sf::Vector2f &position, const resources::GameRegistry::ObjectData &data);
+    /**
+     * @brief Destroy all static objects in the chunk at once.
+     * The memory of the pool is kept for the next objects.
+    */
+    void clearStaticObjects();
+    /**
+     * @brief Copy the textures of the static objects again, see Tile::refreshTexture().
+     * The baked vertices are out of date until the chunk is baked again.
+    */
+    void refreshTextures();
+    /**
+     * @brief Sort the static objects by y position and rebuild the baked data.
+    */
+    void bake();
+    /**
+     * @brief Check if the baked data is up to date with the static objects.
+    */
+    inline bool isBaked() const { return baked; }
+    /**
+     * @brief Get the number of (baked) static objects in the chunk.
+    */
+    inline std::size_t getStaticObjectCount() const { return static_aabbs.size(); }
+    /**
+     * @brief Get the AABBs of the static objects, sorted by the top of the AABB.
+    */
+    inline const std::vector<AABB>& getStaticAABBs() const { return static_aabbs; }
+    /**
+     * @brief Get the vertices of the static objects, 4 per object.
+     * The objects are in the same order as getStaticAABBs().
+    */
+    inline const std::vector<sf::Vertex>& getStaticVertices() const { return static_vertices; }
+    /**
+     * @brief Get the pages of the texture atlas the static objects are drawn with.
+     * The objects are in the same order as getStaticAABBs().
+    */
+    inline const std::vector<uint32_t>& getStaticPages() const { return static_pages; }
+private:
+    /**
+     * @brief The position of the chunk (in chunks, not tiles).
+    */
+    sf::Vector2i position;
+    /**
+     * @brief One bit per tile, set if the tile is solid.
+     * The tiles are stored row by row.
+    */
+    std::bitset<TILE_COUNT> solid;
+    /**
+     * @brief The pool the static objects are allocated from.
+    */
+    ObjectPool<GameObject, 64> static_object_pool;
+    /**
+     * @brief The static objects owned by the chunk.
+     * Sorted by y position when the chunk is baked.
+    */
+    std::vector<GameObject*> static_objects;
+    /**
+     * @brief The baked AABBs of the static objects.
+    */
+    std::vector<AABB> static_aabbs;
+    /**
+     * @brief The baked vertices of the static objects.
+    */
+    std::vector<sf::Vertex> static_vertices;
+    /**
+     * @brief The baked texture atlas pages of the static objects.
+    */
+    std::vector<uint32_t> static_pages;
+    /**
+     * @brief Whether or not the baked data is up to date.
+    */
+    bool baked = true;
+};
+
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <memory>
+
+#include "engine/chunk.hpp"
+#include "engine/aabb.hpp"
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class ChunkMap
+ * @brief The chunks that make up the world.
+ * 
+ * The chunk map is used to look up tile properties, such as whether or not a
+ * tile is solid, and to sweep AABBs through the tile grid. Tiles outside the
+ * world are always solid, so nothing can leave the world.
+ * 
+ * The chunk map also stores the static objects of the world, see Chunk.
+ * A static object is stored in the chunk that contains its top left corner,
+ * so an object can reach into the chunks to the right of and below it, but
+ * never further than that since objects can't be larger than a chunk.
+*/
+class ChunkMap {
+public:
+    /**
+     * @brief Construct a new ChunkMap object.
+     * @param dimensions The dimensions of the world (in tiles).
+    */
+    ChunkMap(const sf::Vector2i &dimensions);
+    /**
+     * @brief Check if a tile is solid.
+     * @param x The x coordinate of the tile.
+     * @param y The y coordinate of the tile.
+     * @return True if the tile is solid or outside the world, false otherwise.
+    */
+    bool isSolid(int x, int y) const;
+    /**
+     * @brief Set whether or not a tile is solid.
+     * Does nothing if the tile is outside the world.
+     * @param x The x coordinate of the tile.
+     * @param y The y coordinate of the tile.
+     * @param is_solid Whether or not the tile is solid.
+    */
+    void setSolid(int x, int y, bool is_solid);
+    /**
+     * @brief Sweep an AABB through the tile grid.
+     * The AABB is first moved along the x axis and then along the y axis, and
+     * is stopped at the first solid tile along each axis. This means that an
+     * object moving diagonally into a wall slides along it.
+     * Only the tiles along the leading edges of the AABB are checked, so the
+     * cost only depends on how many tiles the AABB moves across.
+     * @param aabb The AABB to sweep.
+     * @param offset The offset to move the AABB by.
+     * @return The offset the AABB can move by without entering a solid tile.
+    */
+    sf::Vector2f sweep(const AABB &aabb, const sf::Vector2f &offset) const;
+    /**
+     * @brief Get the chunk that contains a tile.
+     * @param x The x coordinate of the tile.
+     * @param y The y coordinate of the tile.
+     * @return The chunk, or nullptr if the tile is outside the world.
+    */
+    const Chunk* getChunk(int x, int y) const;
+    /**
+     * @brief Get the dimensions of the world (in tiles).
+    */
+    inline const sf::Vector2i& getDimensions() const { return dimensions; }
+    /**
+     * @brief Get the dimensions of the world (in chunks).
+    */
+    inline const sf::Vector2i& getChunkDimensions() const { return chunk_dimensions; }
+    /**
+     * @brief Create a static object in the chunk that contains the top left corner of its AABB.
+     * The object can't collide with anything or be drawn until the chunk is baked.
+     * @param position The position of the object.
+     * @param data The data of the object.
+     * @return The object, which is owned by its chunk.
+     * @throws std::runtime_error if the object is outside the world or larger than a chunk.
+    */
+    GameObject& createStaticObject(const sf::Vector2f &position, const resources::GameRegistry::ObjectData &data);
+    /**
+     * @brief Destroy all static objects of a chunk at once, e.g. when the chunk is evicted.
+     * Does nothing if the chunk is outside the world.
+     * @param chunk_x The x coordinate of the chunk (in chunks, not tiles).
+     * @param chunk_y The y coordinate of the chunk (in chunks, not tiles).
+    */
+    void clearStaticObjects(int chunk_x, int chunk_y);
+    /**
+     * @brief Copy the textures of every static object again, e.g. after the
+     * texture atlas was repacked. The chunks are baked again on the next bake().
+    */
+    void refreshTextures();
+    /**
+     * @brief Bake the chunks whose static objects have changed since the last bake.
+     * This is cheap if nothing has changed.
+    */
+    void bake();
+    /**
+     * @brief Get the chunks whose static objects might overlap an area.
+     * @param area The area.
+     * @param result The chunks (out parameter).
+     * The result is cleared before the chunks are added.
+    */
+    void getChunks(const sf::FloatRect &area, std::vector<const Chunk*> &result) const;
+    /**
+     * @brief Sweep an AABB against the static objects.
+     * See AABB::sweep().
+     * @param aabb The AABB to sweep.
+     * @param offset The offset to move the AABB by.
+     * @param collision_normal The normal of the surface that was hit (out parameter).
+     * @return The time of impact in the range [0, 1], where 1 means nothing was hit.
+    */
+    float sweepStaticObjects(const AABB &aabb, const sf::Vector2f &offset, sf::Vector2f &collision_normal) const;
+    /**
+     * @brief The maximum number of times an AABB can slide along something it
+     * hit during a single call to slide().
+    */
+    static constexpr int MAX_SLIDES = 3;
+    /**
+     * @brief Move an AABB as far as possible along an offset.
+     * The AABB is swept against both the solid tiles and the static objects, so
+     * it can't pass through anything no matter how large the offset is. When it
+     * hits something, it slides along it with whatever movement is left.
+     * @param aabb The AABB to move.
+     * @param offset The offset to move the AABB by.
+     * @return The offset the AABB actually moved by.
+    */
+    sf::Vector2f slide(const AABB &aabb, sf::Vector2f offset) const;
+private:
+    /**
+     * @brief The dimensions of the world (in tiles).
+    */
+    sf::Vector2i dimensions;
+    /**
+     * @brief The dimensions of the world (in chunks).
+    */
+    sf::Vector2i chunk_dimensions;
+    /**
+     * @brief The chunks, stored row by row.
+    */
+    std::vector<Chunk> chunks;
+    /**
+     * @brief The indices of the chunks that have to be baked.
+    */
+    std::vector<std::size_t> unbaked_chunks;
+    /**
+     * @brief Get the range of chunks whose static objects might overlap an area.
+     * The rect is given in chunk coordinates, and the width and height are inclusive.
+     * The range is clamped to the world, so it's empty (negative width or height)
+     * if the area is completely outside the world.
+    */
+    sf::IntRect getChunkRange(const sf::FloatRect &area) const;
+    /**
+     * @brief Non-const version of getChunk().
+    */
+    Chunk* getChunk(int x, int y);
+    /**
+     * @brief Check if any tile in a column is solid.
+     * @param x The x coordinate of the column.
+     * @param y_start The first tile of the column to check.
+     * @param y_end The last tile of the column to check (inclusive).
+    */
+    bool isColumnSolid(int x, int y_start, int y_end) const;
+    /**
+     * @brief Check if any tile in a row is solid.
+     * @param y The y coordinate of the row.
+     * @param x_start The first tile of the row to check.
+     * @param x_end The last tile of the row to check (inclusive).
+    */
+    bool isRowSolid(int y, int x_start, int x_end) const;
+    /**
+     * @brief Sweep an AABB along the x axis.
+     * @return The distance the AABB can move along the x axis.
+    */
+    float sweepX(const AABB &aabb, float dx) const;
+    /**
+     * @brief Sweep an AABB along the y axis.
+     * @return The distance the AABB can move along the y axis.
+    */
+    float sweepY(const AABB &aabb, float dy) const;
+    /**
+     * @brief Small margin used when converting AABB edges to tiles.
+     * This makes sure that an AABB that is exactly touching a tile
+     * isn't considered to be inside it.
+    */
+    static constexpr float EDGE_EPSILON = 1e-4f;
+};
+
+} // namespace engine
+} // namespace rpg
@@ -38,6 +38,36 @@ constexpr float WORLD_GRID_WIDTH = 32.0f;
  * @brief The height of the world grid (in meters/cells).
 */
 constexpr float WORLD_GRID_HEIGHT = WORLD_GRID_WIDTH / ASPECT_RATIO;
+/**
+ * @brief The width and height of a chunk (in meters/cells).
+ * 
+ * The world is divided into square chunks of CHUNK_SIZE x CHUNK_SIZE tiles.
+*/
+constexpr int CHUNK_SIZE = 16;
+/**
+ * @brief How far the flow field towards the player reaches (in meters/cells).
+ * 
+ * Anything further away than this doesn't know how to reach the player.
+*/
+constexpr int FLOW_FIELD_RADIUS = 48;
+/**
+ * @brief The number of tiles of the flow field computed per simulation tick.
+ * 
+ * A full field is (2 * FLOW_FIELD_RADIUS + 1)^2 tiles and takes two passes,
+ * i.e. about 18.8k tiles, so a field is done every 3 ticks. A field is never
+ * restarted just because the player moved (see FLOW_FIELD_MAX_DRIFT), so
+ * followers steer by a field that is at most about 6 ticks behind the player.
+*/
+constexpr int FLOW_FIELD_TILES_PER_TICK = 8192;
+/**
+ * @brief How far the player can move from the flow field being computed before
+ * it is thrown away and started again (in meters/cells).
+ * 
+ * Otherwise the field is finished first and then computed again for wherever
+ * the player is by then. Walking never moves the player this far during the
+ * 3 ticks a field takes, so in practice this only happens when teleporting.
+*/
+constexpr int FLOW_FIELD_MAX_DRIFT = 4;
 /**
  * @brief The scale of the world sprites.
  * 
@@ -71,6 +101,72 @@ constexpr float UI_GRID_HEIGHT = UI_GRID_WIDTH / ASPECT_RATIO;
  * This is the inverse of UI_GRID_CELL_SIZE.
 */
 constexpr float UI_SPRITE_SCALE = 1.0f / UI_GRID_CELL_SIZE;
+/**
+ * @brief The number of simulation ticks per second.
+ * 
+ * The simulation is always advanced in steps of 1 / SIMULATION_TICK_RATE
+ * seconds, regardless of how fast the game is rendered. Rendering
+ * interpolates between the last two simulation ticks.
+*/
+constexpr float SIMULATION_TICK_RATE = 60.0f;
+/**
+ * @brief The duration of a simulation tick (in seconds).
+*/
+constexpr float SIMULATION_TICK = 1.0f / SIMULATION_TICK_RATE;
+/**
+ * @brief The longest frame time that is fed to the simulation (in seconds).
+ * 
+ * If a single frame takes longer than this (e.g. while dragging the window)
+ * the simulation just falls behind, rather than trying to catch up with an
+ * ever growing number of ticks.
+*/
+constexpr float MAX_FRAME_TIME = 0.25f;
+/**
+ * @brief Entities closer than this to the player are simulated every tick (in meters/cells).
+ * 
+ * This should cover the whole view, since entities further away move in steps.
+*/
+constexpr float LOD_NEAR_RADIUS = 32.0f;
+/**
+ * @brief Entities closer than this (but not near) are simulated every LOD_MID_INTERVAL ticks.
+*/
+constexpr float LOD_MID_RADIUS = 64.0f;
+/**
+ * @brief Entities closer than this (but not mid) are simulated every LOD_FAR_INTERVAL ticks.
+ * Anything further away is frozen until it gets closer again.
+*/
+constexpr float LOD_FAR_RADIUS = 128.0f;
+constexpr int LOD_MID_INTERVAL = 4;
+constexpr int LOD_FAR_INTERVAL = 16;
+/**
+ * @brief The number of ticks it takes to recheck the distance of every entity.
+ * 
+ * Only a slice of the entities is rechecked each tick, since entities don't
+ * move far enough within a few ticks for it to matter.
+*/
+constexpr int LOD_RECLASSIFY_TICKS = 8;
+/**
+ * @brief The number of worker threads used by the job system.
+ * 
+ * The main thread also runs jobs while it waits for them, so it isn't
+ * counted here. A negative value means one worker per hardware thread,
+ * minus one for the main thread.
+*/
+constexpr int JOB_THREAD_COUNT = -1;
+/**
+ * @brief Whether or not to reload textures and animations when they change on disk.
+ * 
+ * Handy while working on the art, see GameRegistry::pollHotReload().
+*/
+constexpr bool HOT_RELOAD = true;
+/**
+ * @brief The number of lightweight entities spawned around the player when a
+ * new world is created, all chasing the player.
+ * 
+ * This is only for trying out the ECS, so none are spawned by default. Set it
+ * to e.g. 256 to get a crowd. They're only spawned on tiles they can walk on.
+*/
+constexpr int DEBUG_CROWD_SIZE = 0;
 
 } // namespace constants
 } // namespace engine
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "engine/ecs/entity_handle.hpp"
+#include "engine/ecs/component_store.hpp"
+#include "engine/ecs/components.hpp"
+#include "resources/animation_clip.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @class AnimationBatch
+ * @brief Plays the animations of the lightweight entities, and owns the quads they're drawn with.
+ *
+ * The playback state is stored as a structure of arrays (time, frame rate,
+ * duration, frame count, ...) rather than one AnimationPlayer per entity, so
+ * advancing every animation is a single loop over a few packed arrays, which
+ * the compiler can vectorise. The current frame is then written straight
+ * into the texture coordinates of the entity's quad, which is drawn as is, so
+ * the frames never have to be copied into a Sprite and then into a vertex
+ * array again.
+ *
+ * Like a ComponentStore, the arrays are kept dense by moving the last entity
+ * into the hole when one is removed. Before the quads are drawn, the slots are
+ * sorted by the page of the texture atlas their clip is on, see getBatches().
+ * The world doesn't draw the batches as they are though, it merges the quads
+ * into its y-sorted draw order, see DrawOrder.
+*/
+class AnimationBatch {
+public:
+    /**
+     * @brief A range of quads that are drawn with the same page of the texture atlas.
+    */
+    struct PageBatch {
+        uint32_t page;
+        /**
+         * @brief The first vertex of the range.
+        */
+        std::size_t first;
+        /**
+         * @brief The number of vertices in the range.
+        */
+        std::size_t count;
+    };
+    /**
+     * @brief Start animating an entity.
+     * If the entity is already animated, its clip is replaced.
+     * @param entity The entity.
+     * @param clip_id The id of the clip, see ResourceManager::getAnimationId().
+     * @param clip The clip. Must outlive the batch (clips live as long as the resource manager).
+     * @param flip_x Whether or not to mirror the frames horizontally.
+    */
+    void add(EntityHandle entity, resources::AnimationClipId clip_id, const resources::AnimationClip &clip, bool flip_x = false);
+    /**
+     * @brief Stop animating an entity.
+     * Does nothing if the entity isn't animated.
+     * @param entity The entity.
+    */
+    void remove(EntityHandle entity);
+    /**
+     * @brief Check if an entity is animated.
+     * @param entity The entity.
+    */
+    inline bool has(EntityHandle entity) const {
+        return entity.index < sparse.size() && sparse[entity.index] != NONE &&
+               entities[sparse[entity.index]].generation == entity.generation;
+    }
+    /**
+     * @brief Switch an entity to another clip.
+     * The clip starts over, unless it's already playing.
+     * @param entity The entity, which must be animated.
+     * @param clip_id The id of the clip.
+     * @param clip The clip.
+     * @param flip_x Whether or not to mirror the frames horizontally.
+    */
+    void play(EntityHandle entity, resources::AnimationClipId clip_id, const resources::AnimationClip &clip, bool flip_x = false);
+    /**
+     * @brief Pick up the changes to a clip, e.g. after it was hot reloaded.
+     * Every entity playing the clip keeps its time, but takes the new frames,
+     * frame rate and page.
+     * @param clip_id The id of the clip.
+     * @param clip The changed clip.
+    */
+    void refreshClip(resources::AnimationClipId clip_id, const resources::AnimationClip &clip);
+    /**
+     * @brief Advance every animation and write the current frames to the quads.
+     * @param dt The time since the last update.
+    */
+    void update(float dt);
+    /**
+     * @brief Move the quads to the positions of their entities.
+     * This also sorts the quads by page (if anything changed), see getBatches().
+     * Entities without a Position are collapsed to a point, so they aren't drawn.
+     * @param positions The positions of the entities.
+     * @param alpha How far we are between the previous and the next simulation tick.
+    */
+    void updatePositions(const ComponentStore<Position> &positions, float alpha);
+    /**
+     * @brief Get the animated entities, in the same order as getVertices().
+    */
+    inline const std::vector<EntityHandle>& getEntities() const { return entities; }
+    /**
+     * @brief Get the quads of all animated entities, 4 vertices each.
+    */
+    inline const std::vector<sf::Vertex>& getVertices() const { return vertices; }
+    /**
+     * @brief Get the ranges of getVertices() that are on the same page, in order of page.
+     * This is up to date after updatePositions().
+    */
+    inline const std::vector<PageBatch>& getBatches() const { return batches; }
+    /**
+     * @brief Get the page of the texture atlas of each entity, in the same order as getEntities().
+    */
+    inline const std::vector<uint32_t>& getPages() const { return pages; }
+    /**
+     * @brief Get the number of animated entities.
+    */
+    inline std::size_t size() const { return entities.size(); }
+    /**
+     * @brief Reserve space for a number of entities.
+    */
+    void reserve(std::size_t capacity);
+    /**
+     * @brief Make room for a number of entities on top of the ones in the batch.
+     * See ComponentStore::reserveAdditional().
+    */
+    void reserveAdditional(std::size_t count);
+    /**
+     * @brief Stop animating all entities.
+    */
+    void clear();
+private:
+    /**
+     * @brief Marks an entity that isn't animated in the sparse array.
+    */
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+    std::vector<EntityHandle> entities;
+    /**
+     * @brief The slot in the dense arrays of each entity index (or NONE).
+    */
+    std::vector<uint32_t> sparse;
+    // --- Per entity, indexed by slot ---
+    std::vector<resources::AnimationClipId> clips;
+    /**
+     * @brief The frame rects of each clip, owned by the resource manager.
+    */
+    std::vector<const sf::IntRect*> frames;
+    std::vector<float> times;
+    std::vector<float> frame_rates;
+    std::vector<float> durations;
+    std::vector<uint32_t> frame_counts;
+    std::vector<uint8_t> loops;
+    std::vector<uint8_t> flips;
+    std::vector<uint32_t> current_frames;
+    /**
+     * @brief The page of the texture atlas each clip is on.
+    */
+    std::vector<uint32_t> pages;
+    /**
+     * @brief 4 vertices per entity, in the same order as the other arrays.
+    */
+    std::vector<sf::Vertex> vertices;
+    /**
+     * @brief The ranges of the vertices on each page.
+    */
+    std::vector<PageBatch> batches;
+    /**
+     * @brief Whether or not the slots have to be sorted (and batched) again.
+    */
+    bool batches_dirty = false;
+    /**
+     * @brief Set the clip of a slot and restart it.
+    */
+    void setClip(uint32_t slot, resources::AnimationClipId clip_id, const resources::AnimationClip &clip, bool flip_x);
+    /**
+     * @brief Sort the slots by page, keeping the order within each page, and rebuild the batches.
+    */
+    void sortByPage();
+};
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "engine/ecs/entity_handle.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @class ComponentStore
+ * @brief Stores one type of component for any number of entities.
+ * 
+ * The components are packed into a dense array, so systems can loop over
+ * all of them without any gaps or indirection. A sparse array, indexed by the
+ * entity index, maps each entity to its component in the dense array. Adding,
+ * removing and looking up a component are all O(1). Removing a component
+ * moves the last component into its place, so the order of the components
+ * isn't stable.
+ * @tparam T The type of the component.
+*/
+template <typename T>
+class ComponentStore {
+public:
+    /**
+     * @brief Add a component to an entity.
+     * If the entity already has the component, it's replaced.
+     * @param entity The entity.
+     * @param component The component.
+     * @return The component in the store.
+    */
+    T& add(EntityHandle entity, const T &component = T()) {
+        if (has(entity)) {
+            T &existing = components[sparse[entity.index]];
+            existing = component;
+            return existing;
+        }
+        if (entity.index >= sparse.size()) {
+            sparse.resize(entity.index + 1, NONE);
+        }
+        sparse[entity.index] = components.size();
+        components.push_back(component);
+        entities.push_back(entity);
+        return components.back();
+    }
+    /**
+     * @brief Remove the component of an entity.
+     * Does nothing if the entity doesn't have the component.
+     * @param entity The entity.
+    */
+    void remove(EntityHandle entity) {
+        if (!has(entity)) {
+            return;
+        }
+        // Move the last component into the hole to keep the array dense
+        uint32_t slot = sparse[entity.index];
+        uint32_t last = components.size() - 1;
+        if (slot != last) {
+            components[slot] = std::move(components[last]);
+            entities[slot] = entities[last];
+            sparse[entities[slot].index] = slot;
+        }
+        components.pop_back();
+        entities.pop_back();
+        sparse[entity.index] = NONE;
+    }
+    /**
+     * @brief Check if an entity has the component.
+     * @param entity The entity.
+    */
+    inline bool has(EntityHandle entity) const {
+        return entity.index < sparse.size() && sparse[entity.index] != NONE &&
+               entities[sparse[entity.index]].generation == entity.generation;
+    }
+    /**
+     * @brief Get the component of an entity.
+     * @param entity The entity.
+     * @return The component, or nullptr if the entity doesn't have the component.
+    */
+    inline T* tryGet(EntityHandle entity) { return has(entity) ? &components[sparse[entity.index]] : nullptr; }
+    inline const T* tryGet(EntityHandle entity) const { return has(entity) ? &components[sparse[entity.index]] : nullptr; }
+    /**
+     * @brief Get the component of an entity.
+     * @param entity The entity.
+     * @return The component.
+     * @throws std::runtime_error if the entity doesn't have the component.
+    */
+    T& get(EntityHandle entity) {
+        return const_cast<T&>(static_cast<const ComponentStore*>(this)->get(entity));
+    }
+    const T& get(EntityHandle entity) const {
+        if (!has(entity)) {
+            throw std::runtime_error("ComponentStore::" + std::string(__func__) + "(): Entity " + std::to_string(entity.index) + " doesn't have the component");
+        }
+        return components[sparse[entity.index]];
+    }
+    /**
+     * @brief Get all components, packed together.
+    */
+    inline std::vector<T>& getComponents() { return components; }
+    inline const std::vector<T>& getComponents() const { return components; }
+    /**
+     * @brief Get the entity of each component.
+     * The entities are in the same order as getComponents().
+    */
+    inline const std::vector<EntityHandle>& getEntities() const { return entities; }
+    /**
+     * @brief Get the number of components in the store.
+    */
+    inline std::size_t size() const { return components.size(); }
+    /**
+     * @brief Reserve space for a number of components.
+    */
+    void reserve(std::size_t capacity) {
+        components.reserve(capacity);
+        entities.reserve(capacity);
+    }
+    /**
+     * @brief Make room for a number of components on top of the ones in the store.
+     * Only allocates if they don't fit, and then at least doubles the capacity,
+     * so adding many small batches doesn't reallocate for every batch.
+    */
+    void reserveAdditional(std::size_t count) {
+        if (components.size() + count > components.capacity()) {
+            reserve(std::max(components.size() + count, components.capacity() * 2));
+        }
+    }
+    /**
+     * @brief Remove all components.
+    */
+    void clear() {
+        components.clear();
+        entities.clear();
+        sparse.clear();
+    }
+private:
+    /**
+     * @brief Marks an entity without the component in the sparse array.
+    */
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+    /**
+     * @brief The components, packed together.
+    */
+    std::vector<T> components;
+    /**
+     * @brief The entity of each component.
+    */
+    std::vector<EntityHandle> entities;
+    /**
+     * @brief The slot in the dense arrays of each entity index (or NONE).
+    */
+    std::vector<uint32_t> sparse;
+};
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "resources/resource_manager.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @struct Position
+ * @brief The position of an entity (the top left corner of its sprite).
+*/
+struct Position {
+    sf::Vector2f value;
+    /**
+     * @brief The position at the start of the last tick.
+     * This is used to interpolate the position when drawing.
+    */
+    sf::Vector2f previous;
+};
+
+/**
+ * @struct Velocity
+ * @brief The movement of an entity.
+*/
+struct Velocity {
+    /**
+     * @brief The direction of movement (normalized, or zero if standing still).
+    */
+    sf::Vector2f direction;
+    float speed = 1.0f;
+};
+
+/**
+ * @struct Collider
+ * @brief The AABB of an entity, relative to its position.
+ * Entities with a collider can't move into solid tiles or static objects.
+*/
+struct Collider {
+    sf::Vector2f offset;
+    sf::Vector2f size;
+};
+
+/**
+ * @struct Sprite
+ * @brief The part of the texture atlas an entity is drawn with.
+*/
+struct Sprite {
+    /**
+     * @brief The texture the rect was copied from, see World::refreshTextures().
+    */
+    resources::TextureId texture_id = resources::ResourceManager::INVALID_TEXTURE_ID;
+    sf::IntRect texture_rect;
+    bool flip_x = false;
+    /**
+     * @brief The page of the texture atlas the rect is on.
+    */
+    uint32_t page = 0;
+};
+
+/**
+ * Animated entities don't have a component for their animation, it's played
+ * (and drawn) by the registry's AnimationBatch instead.
+*/
+
+/**
+ * @struct Animator
+ * @brief Switches the animation of an animated entity to match its Velocity,
+ * like an Entity does, see ecs::updateAnimations().
+*/
+struct Animator {
+    /**
+     * @brief The animation table of the entity's kind, see World::spawnEntities().
+    */
+    uint32_t table = 0;
+    /**
+     * @brief The direction the entity last moved in, which it keeps facing when it stops.
+    */
+    sf::Vector2f last_direction;
+};
+
+/**
+ * @struct FlowFieldFollower
+ * @brief Entities with this component steer along the world's flow field,
+ * i.e. they chase the player.
+*/
+struct FlowFieldFollower {};
+
+/**
+ * @struct SimulationLod
+ * @brief How often an entity is simulated, based on its distance to the player.
+ * This is managed by the TickScheduler, and added to entities automatically.
+*/
+struct SimulationLod {
+    /**
+     * @brief The level of detail, see TickScheduler::Level.
+    */
+    uint8_t level = 0;
+    /**
+     * @brief The tick the entity was last updated on.
+    */
+    uint32_t last_tick = 0;
+};
+
+/**
+ * @struct Health
+ * @brief The health of an entity.
+*/
+struct Health {
+    int current = 0;
+    int max = 0;
+};
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "engine/ecs/registry.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @class DrawOrder
+ * @brief Keeps the lightweight entities that are drawn, i.e. that have a
+ * Position and either a Sprite or an animation, sorted by y so the world can
+ * merge them into its draw order.
+ *
+ * The order is a list of sort keys, one per Sprite and AnimationBatch slot,
+ * which is kept from one frame to the next. Entities barely move between two
+ * frames, so it's almost sorted already, and insertion sort fixes it in close
+ * to linear time, like the endpoints in SweepAndPrune. Entities at the same y
+ * are ordered by their slot, so they don't swap places from one frame to the
+ * next.
+ *
+ * Every entity is in the order, in view or not, so entities moving in and out
+ * of view don't have to be inserted and removed. The ones in view are copied
+ * to a separate list after sorting, see getVisibleEntries().
+*/
+class DrawOrder {
+public:
+    /**
+     * @struct Entry
+     * @brief An entity in view.
+    */
+    struct Entry {
+        /**
+         * @brief What the entities are sorted by: the top of the entity's Collider
+         * (or of its quad if it doesn't have one), like the AABBs of the game objects.
+        */
+        float y;
+        /**
+         * @brief The slot of the entity in the Sprite store, or in the AnimationBatch if it's animated.
+        */
+        uint32_t slot;
+        bool animated;
+    };
+    /**
+     * @brief Re-sort the entities after they've moved, and find the ones in view.
+     * The quads of animated entities are taken from the AnimationBatch, so it
+     * must be up to date (see AnimationBatch::updatePositions()).
+     * @param registry The registry.
+     * @param viewport The area that is drawn.
+     * @param alpha How far we are between the previous and the next simulation tick.
+    */
+    void update(const Registry &registry, const sf::FloatRect &viewport, float alpha);
+    /**
+     * @brief Get the entities in view, sorted by y.
+    */
+    inline const std::vector<Entry>& getVisibleEntries() const { return visible_entries; }
+    /**
+     * @brief Get the page of the texture atlas the quad of an entry is on.
+    */
+    static uint32_t getPage(const Registry &registry, const Entry &entry);
+    /**
+     * @brief Append the quad of an entry to a vertex array.
+     * @param registry The registry.
+     * @param entry The entry, from the last update().
+     * @param alpha How far we are between the previous and the next simulation tick.
+     * @param vertex_array The vertex array to append to.
+    */
+    static void appendQuad(const Registry &registry, const Entry &entry, float alpha, sf::VertexArray &vertex_array);
+private:
+    /**
+     * @brief The sort key of every slot, sorted as of the last update().
+     * The upper half is the y, as bits that sort like the float (see getSortableBits()),
+     * and the lower half is the slot, shifted left by one, with the lowest bit set for animated entities.
+    */
+    std::vector<uint64_t> order;
+    /**
+     * @brief The y of each Sprite slot, and whether or not it's in view.
+    */
+    std::vector<float> sprite_ys;
+    std::vector<uint8_t> sprite_visible;
+    /**
+     * @brief The y of each AnimationBatch slot, and whether or not it's in view.
+    */
+    std::vector<float> animated_ys;
+    std::vector<uint8_t> animated_visible;
+    /**
+     * @brief The entries in view, sorted by y.
+     * Kept around so that we don't allocate a new vector every frame.
+    */
+    std::vector<Entry> visible_entries;
+    /**
+     * @brief Add the keys of new slots and remove the ones of slots that no longer exist.
+    */
+    void resize(std::size_t sprite_count, std::size_t animated_count);
+    /**
+     * @brief Sort the keys.
+    */
+    void sort();
+    /**
+     * @brief Get the top left corner of an entity, between its previous and current position.
+    */
+    static sf::Vector2f getTopLeft(const Position &position, float alpha);
+    /**
+     * @brief Get the bits of a float, flipped so that they sort the same way as the float.
+    */
+    static uint32_t getSortableBits(float value);
+};
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
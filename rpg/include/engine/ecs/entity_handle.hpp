@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @struct EntityHandle
+ * @brief A stable reference to an entity in a Registry.
+ * 
+ * The index identifies the slot of the entity, and the generation is bumped
+ * every time the slot is reused. A handle to a destroyed entity therefore
+ * never refers to a new entity that happens to get the same slot.
+*/
+struct EntityHandle {
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+    /**
+     * @brief The index of a handle that doesn't refer to any entity.
+    */
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+    /**
+     * @brief Check if the handle refers to an entity at all.
+     * The entity might still have been destroyed, see Registry::isAlive().
+    */
+    inline bool isValid() const { return index != INVALID_INDEX; }
+    inline bool operator==(const EntityHandle &other) const { return index == other.index && generation == other.generation; }
+    inline bool operator!=(const EntityHandle &other) const { return !(*this == other); }
+};
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
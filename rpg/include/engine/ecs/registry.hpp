@@ -0,0 +1,94 @@
+#pragma once
+
+#include <tuple>
+#include <vector>
+
+#include "engine/ecs/entity_handle.hpp"
+#include "engine/ecs/component_store.hpp"
+#include "engine/ecs/components.hpp"
+#include "engine/ecs/animation_batch.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @class Registry
+ * @brief Creates entities and stores their components.
+ * 
+ * An entity is nothing but a handle, and all of its data lives in the
+ * component stores, one per component type. Systems (see systems.hpp) loop
+ * over the stores directly, rather than calling a virtual update on every
+ * entity, which keeps the per-entity cost down to a few bytes and a few
+ * cache lines even with a very large number of entities.
+*/
+class Registry {
+public:
+    /**
+     * @brief Create a new entity without any components.
+     * @return The handle of the entity.
+    */
+    EntityHandle create();
+    /**
+     * @brief Destroy an entity and remove all of its components.
+     * Does nothing if the entity is already destroyed.
+     * @param entity The entity.
+    */
+    void destroy(EntityHandle entity);
+    /**
+     * @brief Check if an entity exists, i.e. it has been created and not destroyed.
+     * @param entity The entity.
+    */
+    inline bool isAlive(EntityHandle entity) const {
+        return entity.index < generations.size() && generations[entity.index] == entity.generation;
+    }
+    /**
+     * @brief Get the number of entities that are alive.
+    */
+    inline std::size_t size() const { return generations.size() - free_indices.size(); }
+    /**
+     * @brief Reserve space for a number of entities.
+    */
+    void reserve(std::size_t capacity);
+    /**
+     * @brief Get the store of a component type.
+     * @tparam T The type of the component.
+    */
+    template <typename T>
+    inline ComponentStore<T>& getStore() { return std::get<ComponentStore<T>>(stores); }
+    template <typename T>
+    inline const ComponentStore<T>& getStore() const { return std::get<ComponentStore<T>>(stores); }
+    /**
+     * @brief Get the animations of the entities.
+     * Animations aren't stored as a component, see AnimationBatch.
+    */
+    inline AnimationBatch& getAnimationBatch() { return animation_batch; }
+    inline const AnimationBatch& getAnimationBatch() const { return animation_batch; }
+private:
+    /**
+     * @brief The current generation of each entity index.
+    */
+    std::vector<uint32_t> generations;
+    /**
+     * @brief The indices of destroyed entities that can be reused.
+    */
+    std::vector<uint32_t> free_indices;
+    /**
+     * @brief The component stores, one per component type.
+    */
+    std::tuple<
+        ComponentStore<Position>,
+        ComponentStore<Velocity>,
+        ComponentStore<Collider>,
+        ComponentStore<Sprite>,
+        ComponentStore<Animator>,
+        ComponentStore<Health>,
+        ComponentStore<FlowFieldFollower>,
+        ComponentStore<SimulationLod>
+    > stores;
+    AnimationBatch animation_batch;
+};
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
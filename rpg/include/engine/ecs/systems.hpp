@@ -0,0 +1,54 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+#include "engine/ecs/registry.hpp"
+#include "engine/ecs/tick_scheduler.hpp"
+#include "engine/chunk_map.hpp"
+#include "engine/flow_field.hpp"
+#include "engine/animation_table.hpp"
+#include "resources/resource_manager.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * The update systems only touch the entities scheduled for this tick, each
+ * with its own dt, see TickScheduler.
+*/
+
+/**
+ * @brief Point the Velocity of every scheduled FlowFieldFollower along the flow field.
+ * The direction is looked up at the center of the entity's Collider, or at
+ * its Position if it doesn't have one.
+ * @param registry The registry.
+ * @param flow_field The flow field.
+ * @param updates The entities to update.
+*/
+void followFlowField(Registry &registry, const FlowField &flow_field, const std::vector<ScheduledUpdate> &updates);
+/**
+ * @brief Move every scheduled entity with a Position and a Velocity.
+ * Entities that also have a Collider are stopped by solid tiles and static
+ * objects, see ChunkMap::slide().
+ * @param registry The registry.
+ * @param chunk_map The chunk map to collide with, or nullptr to ignore collisions.
+ * @param updates The entities to update.
+*/
+void updateMovement(Registry &registry, const ChunkMap *chunk_map, const std::vector<ScheduledUpdate> &updates);
+/**
+ * @brief Switch the animation of every scheduled entity with an Animator to match its Velocity.
+ * Moving entities walk in the direction they move in, and entities standing
+ * still idle facing the way they last moved. The clip only starts over when
+ * it changes, see AnimationBatch::play().
+ * @param registry The registry.
+ * @param tables The animation tables, indexed by Animator::table.
+ * @param resource_manager The resource manager the clips are in.
+ * @param updates The entities to update.
+*/
+void updateAnimations(Registry &registry, const std::vector<AnimationTable> &tables,
+    const resources::ResourceManager &resource_manager, const std::vector<ScheduledUpdate> &updates);
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
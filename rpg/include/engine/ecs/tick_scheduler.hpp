@@ -0,0 +1,134 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "engine/ecs/registry.hpp"
+#include "engine/constants.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @struct ScheduledUpdate
+ * @brief An entity that should be updated this tick.
+*/
+struct ScheduledUpdate {
+    EntityHandle entity;
+    /**
+     * @brief The time since the entity was last updated.
+    */
+    float dt;
+    /**
+     * @brief Whether or not the entity is drawn interpolated between ticks.
+     * Entities that aren't updated every tick snap to their new position instead.
+    */
+    bool interpolate;
+};
+
+/**
+ * @class TickScheduler
+ * @brief Decides which entities are simulated each tick, based on how far
+ * they are from the player.
+ *
+ * Near entities are updated every tick, mid-range entities every few ticks and
+ * far entities even less often, each time with the time that has passed since
+ * their last update. Entities further away than that are frozen. Each entity
+ * is offset by its index, so the mid and far entities are spread evenly across
+ * the ticks rather than all being updated on the same tick.
+ *
+ * The entities are kept in lists by level of detail, with the mid and far
+ * levels split into one list per offset, so a tick only visits the near
+ * entities, the mid and far entities that are due, and the slice of entities
+ * that have their distance checked. Frozen entities cost nothing until their
+ * slice comes around.
+ *
+ * This keeps the cost of a tick mostly down to the entities around the player,
+ * no matter how many entities there are in the world. The collision sweep
+ * works for any dt, so updating rarely doesn't let entities pass through walls.
+*/
+class TickScheduler {
+public:
+    /**
+     * @brief The levels of detail.
+    */
+    enum Level : uint8_t {
+        NEAR = 0,
+        MID,
+        FAR,
+        FROZEN
+    };
+    /**
+     * @brief Advance to the next tick and find the entities to update.
+     * Every entity with a Position is scheduled, the rest are ignored. Entities
+     * that are destroyed or lose their Position are dropped when they're next
+     * visited.
+     * @param registry The registry.
+     * @param focus The position that decides the level of detail, usually the player.
+     * @param dt The duration of a tick.
+    */
+    void schedule(Registry &registry, const sf::Vector2f &focus, float dt);
+    /**
+     * @brief Get the entities to update this tick.
+    */
+    inline const std::vector<ScheduledUpdate>& getUpdates() const { return updates; }
+    /**
+     * @brief Get the number of entities at a level of detail (for debugging).
+     * Destroyed entities are still counted until they're dropped.
+    */
+    inline std::size_t getCount(Level level) const { return counts[level]; }
+private:
+    /**
+     * @brief The number of entity lists: one near, one per mid and far offset and one frozen.
+    */
+    static constexpr std::size_t LIST_COUNT = 2 + constants::LOD_MID_INTERVAL + constants::LOD_FAR_INTERVAL;
+    uint32_t tick = 0;
+    std::vector<ScheduledUpdate> updates;
+    std::size_t counts[4] = {0, 0, 0, 0};
+    /**
+     * @brief The entities of each level of detail, see getList().
+    */
+    std::vector<EntityHandle> lists[LIST_COUNT];
+    /**
+     * @brief Classify the entities with a Position that aren't in a list yet.
+    */
+    void addNewEntities(ComponentStore<SimulationLod> &lods, const ComponentStore<Position> &positions, const sf::Vector2f &focus, float dt);
+    /**
+     * @brief Check the distance of this tick's slice of a list, and move the
+     * entities whose level of detail changed to their new list.
+    */
+    void reclassify(ComponentStore<SimulationLod> &lods, const ComponentStore<Position> &positions, std::size_t list, const sf::Vector2f &focus, float dt);
+    /**
+     * @brief Schedule every entity of a list that wasn't updated this tick yet.
+    */
+    void scheduleList(ComponentStore<SimulationLod> &lods, std::size_t list, float dt);
+    /**
+     * @brief Add an entity to the list of its level of detail.
+     * Entities that are overdue at their new level are scheduled right away.
+    */
+    void insert(EntityHandle entity, SimulationLod &lod, float dt);
+    /**
+     * @brief Remove the entity at an index of a list, moving the last one into its place.
+    */
+    void erase(std::size_t list, std::size_t index);
+    /**
+     * @brief Get the list of an entity at a level of detail.
+     * @param level The level of detail.
+     * @param index The index of the entity, which picks the list at the mid and far levels.
+    */
+    static std::size_t getList(Level level, uint32_t index);
+    /**
+     * @brief Get the level of detail at a distance (squared) from the focus.
+    */
+    static Level getLevel(float distance_squared);
+    /**
+     * @brief Get the number of ticks between updates at a level of detail.
+    */
+    static uint32_t getInterval(Level level);
+};
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
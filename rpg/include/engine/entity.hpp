@@ -1,7 +1,8 @@
 #pragma once
 
 #include "engine/mobile_object.hpp"
-#include "resources/animation.hpp"
+#include "engine/animation_table.hpp"
+#include "resources/animation_player.hpp"
 
 namespace rpg {
 namespace engine {
@@ -47,11 +48,7 @@ public:
      * @brief Check if the entity is dead.
     */
     inline bool isDead() const { return health <= 0; }
-protected:
-    int health;
-    int max_health;
-    std::map<std::string, resources::Animation&> animations;
-    
+
     // --- Default entity animations ---
     static constexpr const char* IDLE_DOWN = "idle_down";
     static constexpr const char* IDLE_UP = "idle_up";
@@ -64,19 +61,18 @@ protected:
     static constexpr const char* ATTACK_DOWN = "attack_down";
     static constexpr const char* ATTACK_UP = "attack_up";
     static constexpr const char* ATTACK_LEFT_RIGHT = "attack_left_right";
-
+protected:
+    int health;
+    int max_health;
     /**
-     * @brief Get the idle animation key.
-     * This is based on the previous direction of the entity.
-     * @return The idle animation key.
+     * @brief The animation for each state and facing.
+     * This is resolved from the animation keys once, when the entity is created.
     */
-    std::string getIdleAnimationKey(bool &flip) const;
+    AnimationTable animation_table;
     /**
-     * @brief Get the movement animation key.
-     * This is based on the direction of the entity.
-     * @return The movement animation key.
+     * @brief The playback state of the current animation.
     */
-    std::string getMovementAnimationKey(bool &flip) const;
+    resources::AnimationPlayer animation_player;
 };
 
 } // namespace engine
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "engine/chunk_map.hpp"
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class FlowField
+ * @brief Directions towards a shared goal for every tile around it.
+ *
+ * When lots of agents are heading for the same place (usually the player),
+ * finding a path for each of them repeats the same work over and over.
+ * Instead, the distance from the goal to every tile within a square window
+ * around it is computed once (the integration field), and each tile then
+ * points towards its neighbour closest to the goal (the direction field).
+ * Steering an agent is a single lookup of the tile it's standing on.
+ *
+ * Computing the field is spread over several calls to update(), with a fixed
+ * number of tiles per call, so moving the goal never causes a spike. Lookups
+ * keep using the previous field until the new one is done. If the goal moves
+ * while a field is being computed, that field is finished first and the new
+ * goal is picked up afterwards, unless it has moved so far that the field
+ * would be useless.
+*/
+class FlowField {
+public:
+    /**
+     * @brief Construct a new FlowField object.
+     * @param chunk_map The chunk map used to check if a tile is solid.
+     * Must outlive the flow field.
+     * @param radius How far the field reaches from the goal (in tiles).
+     * @param max_drift How far the goal can move from the field being computed
+     * before that field is thrown away (in tiles).
+    */
+    FlowField(const ChunkMap &chunk_map, int radius, int max_drift);
+    /**
+     * @brief Set the goal of the field.
+     * Starts computing a new field if the goal has changed. If a field is still
+     * being computed, it is finished first and the goal is used once it's done,
+     * unless the goal is more than max_drift tiles away from it.
+     * @param goal The tile to move towards.
+    */
+    void setGoal(const sf::Vector2i &goal);
+    /**
+     * @brief Continue computing the field.
+     * @param budget The maximum number of tiles to process.
+     * @return True if the field is done (or nothing was being computed).
+    */
+    bool update(int budget);
+    /**
+     * @brief Force the field to be recomputed, e.g. after tiles have changed.
+    */
+    void invalidate();
+    /**
+     * @brief Get the direction to move in from a position.
+     * @param position The position (in tiles, not necessarily whole).
+     * @return The normalized direction, or (0, 0) if the position is at the
+     * goal, outside the field, or can't reach the goal.
+    */
+    sf::Vector2f getDirection(const sf::Vector2f &position) const;
+    /**
+     * @brief Get the goal of the field that is currently used for lookups.
+    */
+    inline const sf::Vector2i& getGoal() const { return front.goal; }
+private:
+    /**
+     * @brief Marks a tile that can't reach the goal.
+    */
+    static constexpr uint16_t UNREACHABLE = 0xFFFF;
+    /**
+     * @brief The index of the "don't move" direction, see DIRECTIONS in the source.
+    */
+    static constexpr uint8_t NO_DIRECTION = 8;
+    /**
+     * @struct Field
+     * @brief A computed (or partially computed) field.
+    */
+    struct Field {
+        sf::Vector2i goal;
+        /**
+         * @brief The top left tile of the window.
+        */
+        sf::Vector2i origin;
+        /**
+         * @brief The distance from each tile to the goal, row by row.
+        */
+        std::vector<uint16_t> distances;
+        /**
+         * @brief The direction (index) of each tile, row by row.
+        */
+        std::vector<uint8_t> directions;
+    };
+    /**
+     * @brief The steps of computing a field.
+    */
+    enum class Phase {
+        DONE,
+        INTEGRATION,
+        DIRECTIONS
+    };
+    const ChunkMap &chunk_map;
+    /**
+     * @brief The width and height of the window.
+    */
+    int size;
+    int radius;
+    int max_drift;
+    /**
+     * @brief The field used for lookups.
+    */
+    Field front;
+    /**
+     * @brief The field being computed.
+    */
+    Field back;
+    Phase phase = Phase::DONE;
+    /**
+     * @brief The queue of the breadth-first search from the goal.
+    */
+    std::vector<uint32_t> queue;
+    std::size_t queue_head = 0;
+    /**
+     * @brief The next tile to compute the direction of.
+    */
+    std::size_t next_direction = 0;
+    bool has_goal = false;
+    /**
+     * @brief The goal to compute next, once the back field is done.
+    */
+    sf::Vector2i pending_goal;
+    bool has_pending_goal = false;
+    /**
+     * @brief Start computing a new field in the back buffer.
+    */
+    void start(const sf::Vector2i &goal);
+    /**
+     * @brief Check if a tile in the window of the back field is walkable.
+    */
+    bool isWalkable(int x, int y) const;
+    /**
+     * @brief Find the direction of a tile in the back field.
+    */
+    uint8_t findDirection(int x, int y) const;
+};
+
+} // namespace engine
+} // namespace rpg
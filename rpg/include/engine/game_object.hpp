@@ -43,7 +43,19 @@ public:
     /**
      * @brief Get the AABB of the object.
     */
-    inline AABB getAABB() const { return aabb; }
+    inline const AABB& getAABB() const { return aabb; }
+    /**
+     * @brief Get the offset from the current position of the object to the
+     * position it should be drawn at.
+     * Static objects don't move between simulation ticks, so this is always zero.
+     * @param alpha How far we are between the previous and the next simulation tick.
+    */
+    virtual sf::Vector2f getInterpolationOffset(float alpha) const { return sf::Vector2f(0.0f, 0.0f); }
+    /**
+     * @brief Check if the object can move.
+     * Static objects never move, so they never have to be pushed out of a collision.
+    */
+    virtual bool isMobile() const { return false; }
 protected:
     /**
      * @brief The axis-aligned bounding box of the object.
@@ -37,9 +37,22 @@ public:
     inline const GameState* getCurrentState() const { return current_state.get(); }
     /**
      * @brief Update the current game state.
-     * @param delta_time The time since the last update.
+     * This advances the simulation by one fixed tick.
+     * @param delta_time The duration of the tick.
     */
     void update(float delta_time);
+    /**
+     * @brief Update the UI of the current game state.
+     * Unlike the simulation, the UI is updated once per rendered frame.
+     * @param delta_time The time since the last frame.
+    */
+    void updateUI(float delta_time);
+    /**
+     * @brief Interpolate the current game state before drawing it.
+     * @param alpha How far we are between the previous and the next
+     * simulation tick, in the range [0, 1].
+    */
+    void interpolate(float alpha);
     /**
      * @brief Draw the current game state.
      * 
@@ -37,6 +37,14 @@ public:
      * @param delta_time The time since the last update.
     */
     void updateUI(float delta_time);
+    /**
+     * @brief Interpolate between the last two simulation ticks.
+     * This is called once per frame before drawing. By default it does
+     * nothing, since most states don't have anything that moves.
+     * @param alpha How far we are between the previous and the next
+     * simulation tick, in the range [0, 1].
+    */
+    virtual void interpolate(float alpha) {}
     /**
      * @brief Draw the game state.
     */
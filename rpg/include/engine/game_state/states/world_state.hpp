@@ -26,6 +26,7 @@ public:
     WorldState(GameStateManager *game_state_manager, std::shared_ptr<World> world);
 
     void update(float delta_time) override;
+    void interpolate(float alpha) override;
     void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
     void drawDebug(sf::RenderTarget &target, sf::RenderStates states) const override;
     sf::View getView() const override;
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class JobCounter
+ * @brief Keeps track of a group of jobs that haven't finished yet.
+ * 
+ * Every job scheduled with a counter increments it, and decrements it once
+ * it's done. Waiting on the counter (see JobSystem::wait()) waits for the
+ * whole group, and a job can depend on a counter so that it only starts
+ * once another group of jobs is done.
+ *
+ * If a job throws, the job still counts as done, and the first exception
+ * thrown by any job of the group is kept and rethrown by JobSystem::wait().
+*/
+class JobCounter {
+public:
+    /**
+     * @brief Check if all jobs of the counter are done.
+    */
+    inline bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+private:
+    friend class JobSystem;
+    std::atomic<int> pending{0};
+    /**
+     * @brief Set by the first job that throws, which then stores the exception.
+    */
+    std::atomic<bool> failed{false};
+    std::exception_ptr exception;
+};
+
+/**
+ * @class JobSystem
+ * @brief Runs jobs on a pool of worker threads.
+ * 
+ * Each worker (and the main thread) has its own queue of jobs. A thread
+ * pushes and pops jobs at the back of its own queue, which keeps related jobs
+ * on the same thread, and when its queue is empty it steals from the front of
+ * the other queues. This keeps all threads busy without a single shared queue
+ * that every thread fights over.
+ * 
+ * Threads that wait for jobs to finish don't block, they help run jobs
+ * until the jobs they're waiting for are done. This also means that
+ * everything still works with zero worker threads, the waiting thread
+ * just ends up running every job itself.
+*/
+class JobSystem {
+public:
+    /**
+     * @brief A function that is run by the job system.
+    */
+    using Job = std::function<void()>;
+    /**
+     * @brief Called after every job with the name of the job (if any), how
+     * long it took, and the index of the thread that ran it.
+     * The hook is called from the worker threads, so it must be thread safe.
+    */
+    using TimingHook = std::function<void(const char *name, std::chrono::nanoseconds duration, std::size_t thread_index)>;
+    static JobSystem& getInstance() {
+        static JobSystem instance;
+        return instance;
+    }
+    JobSystem(JobSystem const&) = delete;
+    void operator=(JobSystem const&) = delete;
+    ~JobSystem();
+    /**
+     * @brief Start the worker threads.
+     * Any workers that are already running are stopped first.
+     * @param thread_count The number of worker threads, not counting the main thread.
+     * If this is negative, one worker is started per hardware thread (minus the main thread).
+    */
+    void start(int thread_count = -1);
+    /**
+     * @brief Finish all queued jobs and stop the worker threads.
+    */
+    void stop();
+    /**
+     * @brief Get the number of worker threads (not counting the main thread).
+    */
+    inline std::size_t getThreadCount() const { return workers.size(); }
+    /**
+     * @brief Schedule a job.
+     * @param job The job.
+     * @param counter The counter of the group the job belongs to (optional).
+     * @param name The name of the job, passed to the timing hook (optional).
+     * The string must outlive the job.
+     * @param dependency The job doesn't start until this counter is done (optional).
+    */
+    void schedule(Job job, JobCounter *counter = nullptr, const char *name = nullptr, const JobCounter *dependency = nullptr);
+    /**
+     * @brief Wait for all jobs of a counter to finish.
+     * The calling thread runs jobs while it waits.
+     * @param counter The counter.
+     * @throws The first exception thrown by any of the jobs, once all of them are done.
+    */
+    void wait(const JobCounter &counter);
+    /**
+     * @brief Run a function over a range of indices, split into batches.
+     * Returns once the whole range is done.
+     * @param begin The first index.
+     * @param end One past the last index.
+     * @param batch_size The number of indices per job. Small ranges are run
+     * directly on the calling thread.
+     * @param body Called with the start and end (exclusive) of each batch.
+     * @param name The name of the jobs, passed to the timing hook (optional).
+     * @throws The first exception thrown by the body, once every batch is done.
+    */
+    void parallelFor(std::size_t begin, std::size_t end, std::size_t batch_size,
+                     const std::function<void(std::size_t, std::size_t)> &body, const char *name = nullptr);
+    /**
+     * @brief Set the function that is called after every job.
+     * Timing is skipped entirely if no hook is set.
+     * @param hook The hook, or nullptr to remove it.
+    */
+    void setTimingHook(TimingHook hook);
+private:
+    JobSystem();
+    /**
+     * @struct QueuedJob
+     * @brief A job along with the bookkeeping the job system needs to run it.
+    */
+    struct QueuedJob {
+        Job job;
+        JobCounter *counter = nullptr;
+        const char *name = nullptr;
+        const JobCounter *dependency = nullptr;
+    };
+    /**
+     * @struct Queue
+     * @brief The queue of a single thread.
+     * The owner uses the back, and other threads steal from the front.
+    */
+    struct Queue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+    /**
+     * @brief One queue per worker, and a last one shared by all other threads
+     * (i.e. the main thread).
+    */
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    /**
+     * @brief The number of jobs in all queues.
+    */
+    std::atomic<std::size_t> queued_jobs{0};
+    /**
+     * @brief Bumped whenever a job is pushed or a counter reaches zero, i.e.
+     * whenever a job might have become ready to run. Workers that found
+     * nothing to run sleep until it changes.
+    */
+    std::atomic<std::size_t> wake_generation{0};
+    std::atomic<bool> running{false};
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_condition;
+    /**
+     * @brief Guards the timing hook, since it can be changed while jobs are running.
+    */
+    std::mutex hook_mutex;
+    TimingHook timing_hook;
+    std::atomic<bool> has_timing_hook{false};
+    /**
+     * @brief The main loop of a worker thread.
+    */
+    void workerLoop(std::size_t index);
+    /**
+     * @brief Get the index of the queue of the calling thread.
+    */
+    std::size_t getQueueIndex() const;
+    /**
+     * @brief Push a job to a queue and wake up a worker.
+    */
+    void push(std::size_t queue_index, QueuedJob job);
+    /**
+     * @brief Take a job from a queue, or steal one from another queue,
+     * and run it.
+     * @return True if a job was run, false if there was nothing to run.
+    */
+    bool runNextJob(std::size_t queue_index);
+    /**
+     * @brief Try to take a job that is ready to run from a queue.
+     * @param from_back Whether to take the job from the back (own queue) or the front (stealing).
+    */
+    bool tryTake(Queue &queue, bool from_back, QueuedJob &job);
+    /**
+     * @brief Bump wake_generation and wake up the workers.
+     * @param all Wake every worker rather than just one.
+    */
+    void wake(bool all);
+    /**
+     * @brief Run a job and report its timing.
+     * Anything the job throws is stored on its counter (or reported, if it has none).
+    */
+    void run(QueuedJob &job, std::size_t queue_index);
+};
+
+} // namespace engine
+} // namespace rpg
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "engine/game_object.hpp"
+#include "engine/chunk_map.hpp"
 
 namespace rpg {
 namespace engine {
@@ -23,6 +24,9 @@ public:
     MobileObject(const sf::Vector2f &position, const resources::GameRegistry::ObjectData &data);
     /**
      * @brief Update the object.
+     * The object is swept along its path, so it can't pass through solid tiles
+     * or static objects no matter how large dt is. When it hits something, it
+     * slides along it with whatever movement is left (see ChunkMap::slide()).
      * @param dt The time since the last update.
     */
     void update(float dt);
@@ -41,6 +45,19 @@ public:
      * @param other The other game object.
     */
     void resolveCollision(const GameObject &other);
+    /**
+     * @brief Resolve a collision with another mobile object.
+     * Both objects are pushed apart by half the penetration depth each.
+     * @param other The other mobile object.
+    */
+    void resolveCollision(MobileObject &other);
+    /**
+     * @brief Set the chunk map the object collides with.
+     * Once this is set, the object can't move into solid tiles or static objects.
+     * Collisions with other mobile objects are still resolved by the world.
+     * @param chunk_map The chunk map, or nullptr to ignore the tiles and static objects.
+    */
+    inline void setChunkMap(const ChunkMap *chunk_map) { this->chunk_map = chunk_map; }
     /**
      * @brief Set the speed of the object.
      * @param speed The speed of the object.
@@ -57,8 +74,29 @@ public:
      * @note This is based on the direction of the entity.
     */
     bool isMoving() const;
+    /**
+     * @brief Get the offset from the current position to the interpolated
+     * position between the previous and the current simulation tick.
+     * @param alpha How far we are between the previous and the next simulation tick.
+    */
+    sf::Vector2f getInterpolationOffset(float alpha) const override;
+    inline bool isMobile() const override { return true; }
+    /**
+     * @brief Get the interpolated position of the object.
+     * @param alpha How far we are between the previous and the next simulation tick.
+    */
+    inline sf::Vector2f getInterpolatedPosition(float alpha) const { return position + getInterpolationOffset(alpha); }
 protected:
     float speed = 1.0f;
+    /**
+     * @brief The position of the object at the start of the last update.
+     * This is used to interpolate the position when drawing.
+    */
+    sf::Vector2f previous_position;
+    /**
+     * @brief The chunk map the object collides with (if any).
+    */
+    const ChunkMap *chunk_map = nullptr;
     sf::Vector2f direction;
     sf::Vector2f previous_direction;
 };
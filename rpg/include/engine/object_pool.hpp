@@ -0,0 +1,214 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @struct ObjectHandle
+ * @brief Refers to an object in an ObjectPool.
+ *
+ * Slots are reused after an object is destroyed, so a handle also stores the
+ * generation of its slot. Once the object is destroyed the generation of the
+ * slot changes, and any handles still referring to it are no longer valid.
+*/
+struct ObjectHandle {
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+    uint32_t index = INVALID_INDEX;
+    uint32_t generation = 0;
+    /**
+     * @brief Check if the handle refers to a slot at all.
+     * This doesn't check if the object still exists, see ObjectPool::isValid().
+    */
+    inline bool isValid() const { return index != INVALID_INDEX; }
+    inline bool operator==(const ObjectHandle &other) const { return index == other.index && generation == other.generation; }
+    inline bool operator!=(const ObjectHandle &other) const { return !(*this == other); }
+};
+
+/**
+ * @class ObjectPool
+ * @brief Stores objects of one type in fixed size blocks.
+ *
+ * Objects are constructed in place in the slots of the blocks, so creating
+ * one doesn't allocate (unless every block is full), and objects created
+ * together end up next to each other in memory. Blocks are never moved, so
+ * pointers to the objects stay valid until they're destroyed.
+ *
+ * Free slots form a linked list through the slots themselves, which makes
+ * both create() and destroy() O(1). clear() destroys every object at once but
+ * keeps the blocks around, so a pool can be refilled without allocating.
+ * @tparam T The type of the objects.
+ * @tparam BLOCK_SIZE The number of objects per block.
+*/
+template <typename T, std::size_t BLOCK_SIZE = 256>
+class ObjectPool {
+public:
+    ObjectPool() = default;
+    ~ObjectPool() { clear(); }
+    ObjectPool(ObjectPool &&other) noexcept { *this = std::move(other); }
+    ObjectPool& operator=(ObjectPool &&other) noexcept {
+        if (this != &other) {
+            clear();
+            blocks = std::move(other.blocks);
+            used_slots = std::exchange(other.used_slots, 0);
+            free_head = std::exchange(other.free_head, NONE);
+            count = std::exchange(other.count, 0);
+        }
+        return *this;
+    }
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+    /**
+     * @brief Construct a new object in the pool.
+     * @param args The arguments passed to the constructor of the object.
+     * @return The handle of the object.
+    */
+    template <typename... Args>
+    ObjectHandle create(Args&&... args) {
+        uint32_t index;
+        if (free_head != NONE) {
+            index = free_head;
+        } else {
+            if (used_slots == blocks.size() * BLOCK_SIZE) {
+                blocks.emplace_back(new Slot[BLOCK_SIZE]);
+            }
+            index = used_slots;
+        }
+        Slot &slot = getSlot(index);
+        // Construct first, so nothing changes if the constructor throws
+        new (slot.storage) T(std::forward<Args>(args)...);
+        if (index == free_head) {
+            free_head = slot.next_free;
+        } else {
+            used_slots++;
+        }
+        slot.alive = true;
+        count++;
+        return ObjectHandle{index, slot.generation};
+    }
+    /**
+     * @brief Destroy an object.
+     * Does nothing if the handle is no longer valid.
+     * @param handle The handle of the object.
+    */
+    void destroy(ObjectHandle handle) {
+        if (!isValid(handle)) {
+            return;
+        }
+        release(handle.index);
+    }
+    /**
+     * @brief Check if a handle refers to an object that still exists.
+    */
+    inline bool isValid(ObjectHandle handle) const {
+        return handle.index < used_slots && getSlot(handle.index).alive && getSlot(handle.index).generation == handle.generation;
+    }
+    /**
+     * @brief Get an object.
+     * @param handle The handle of the object.
+     * @return The object, or nullptr if the handle is no longer valid.
+    */
+    inline T* get(ObjectHandle handle) { return isValid(handle) ? getObject(getSlot(handle.index)) : nullptr; }
+    inline const T* get(ObjectHandle handle) const { return isValid(handle) ? getObject(getSlot(handle.index)) : nullptr; }
+    /**
+     * @brief Call a function for every object in the pool, in the order of their slots.
+     * @param function Called with a reference to each object.
+    */
+    template <typename F>
+    void forEach(F &&function) {
+        for (uint32_t i = 0; i < used_slots; i++) {
+            Slot &slot = getSlot(i);
+            if (slot.alive) {
+                function(*getObject(slot));
+            }
+        }
+    }
+    template <typename F>
+    void forEach(F &&function) const {
+        for (uint32_t i = 0; i < used_slots; i++) {
+            const Slot &slot = getSlot(i);
+            if (slot.alive) {
+                function(*getObject(slot));
+            }
+        }
+    }
+    /**
+     * @brief Destroy every object at once.
+     * The blocks are kept, and handles to the destroyed objects become invalid.
+    */
+    void clear() {
+        for (uint32_t i = 0; i < used_slots; i++) {
+            Slot &slot = getSlot(i);
+            if (slot.alive) {
+                getObject(slot)->~T();
+                slot.alive = false;
+                slot.generation++;
+            }
+        }
+        used_slots = 0;
+        free_head = NONE;
+        count = 0;
+    }
+    /**
+     * @brief Allocate enough blocks for a number of objects.
+    */
+    void reserve(std::size_t capacity) {
+        while (blocks.size() * BLOCK_SIZE < capacity) {
+            blocks.emplace_back(new Slot[BLOCK_SIZE]);
+        }
+    }
+    /**
+     * @brief Get the number of objects in the pool.
+    */
+    inline std::size_t size() const { return count; }
+private:
+    static constexpr uint32_t NONE = 0xFFFFFFFF;
+    /**
+     * @struct Slot
+     * @brief Storage for a single object.
+    */
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+        uint32_t generation = 0;
+        /**
+         * @brief The next free slot, only used while the slot is free.
+        */
+        uint32_t next_free = NONE;
+        bool alive = false;
+    };
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+    /**
+     * @brief The number of slots that have been handed out since the last clear().
+     * Slots past this have never been used, and aren't part of the free list.
+    */
+    uint32_t used_slots = 0;
+    /**
+     * @brief The first free slot (or NONE).
+    */
+    uint32_t free_head = NONE;
+    std::size_t count = 0;
+    inline Slot& getSlot(uint32_t index) { return blocks[index / BLOCK_SIZE][index % BLOCK_SIZE]; }
+    inline const Slot& getSlot(uint32_t index) const { return blocks[index / BLOCK_SIZE][index % BLOCK_SIZE]; }
+    static inline T* getObject(Slot &slot) { return std::launder(reinterpret_cast<T*>(slot.storage)); }
+    static inline const T* getObject(const Slot &slot) { return std::launder(reinterpret_cast<const T*>(slot.storage)); }
+    /**
+     * @brief Destroy the object in a slot and add the slot to the free list.
+    */
+    void release(uint32_t index) {
+        Slot &slot = getSlot(index);
+        getObject(slot)->~T();
+        slot.alive = false;
+        slot.generation++;
+        slot.next_free = free_head;
+        free_head = index;
+        count--;
+    }
+};
+
+} // namespace engine
+} // namespace rpg
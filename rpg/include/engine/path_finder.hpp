@@ -0,0 +1,170 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "engine/chunk_map.hpp"
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class PathFinder
+ * @brief Hierarchical pathfinding (HPA*) over the tile grid.
+ *
+ * Searching the whole tile grid with A* gets expensive on large worlds, so
+ * the search is split in two levels. Where two neighbouring chunks share a
+ * stretch of walkable tiles along their border, an entrance is placed, with a
+ * node on either side of the border. Within each chunk, the distance between
+ * every pair of its nodes is precomputed (along with the paths, which are
+ * cached the first time they're needed). A path is then found by searching
+ * this much smaller graph of entrances, and only afterwards turned back into
+ * tiles.
+ *
+ * When a tile changes solidity, only its chunk (and the neighbouring chunk,
+ * if the tile is on a border) are rebuilt, and only once a path is needed.
+ *
+ * Agents move between orthogonally adjacent tiles, and are assumed to be
+ * one tile large.
+*/
+class PathFinder {
+public:
+    /**
+     * @brief Construct a new PathFinder object.
+     * All chunks start out as dirty, and are built on the first search.
+     * @param chunk_map The chunk map used to check if a tile is solid.
+     * Must outlive the path finder.
+    */
+    PathFinder(const ChunkMap &chunk_map);
+    /**
+     * @brief Find a path between two tiles.
+     * @param start The tile to start at.
+     * @param goal The tile to end at.
+     * @param path The tiles along the path, including the start and the goal (out parameter).
+     * The path is cleared before the tiles are added.
+     * @return True if a path was found, false otherwise.
+    */
+    bool findPath(const sf::Vector2i &start, const sf::Vector2i &goal, std::vector<sf::Vector2i> &path);
+    /**
+     * @brief Mark a tile as changed.
+     * Must be called whenever the solidity of a tile changes.
+     * @param x The x coordinate of the tile.
+     * @param y The y coordinate of the tile.
+    */
+    void invalidateTile(int x, int y);
+    /**
+     * @brief Get the number of nodes in the abstract graph (for debugging).
+     * Chunks that haven't been built yet aren't counted.
+    */
+    std::size_t getNodeCount() const;
+private:
+    /**
+     * @brief Entrances at least this long get a node at each end rather than
+     * a single node in the middle, so paths don't have to detour through the middle.
+    */
+    static constexpr int LONG_ENTRANCE_LENGTH = 6;
+    /**
+     * @brief The number of tiles in a chunk.
+    */
+    static constexpr int CHUNK_TILES = constants::CHUNK_SIZE * constants::CHUNK_SIZE;
+    /**
+     * @brief Marks an unreachable tile or a missing node.
+    */
+    static constexpr uint16_t NONE = 0xFFFF;
+    /**
+     * @struct ChunkGraph
+     * @brief The nodes of a chunk, and the paths between them.
+     * Tiles are identified by their index within the chunk.
+    */
+    struct ChunkGraph {
+        /**
+         * @brief The tile of each node.
+        */
+        std::vector<uint16_t> nodes;
+        /**
+         * @brief The node on each tile (or NONE).
+        */
+        std::vector<uint16_t> node_at;
+        /**
+         * @brief The distance between each pair of nodes (or NONE), row by row.
+        */
+        std::vector<uint16_t> distances;
+        /**
+         * @brief For each node, the previous tile on the shortest path to
+         * every tile in the chunk, see search().
+        */
+        std::vector<std::vector<uint16_t>> parents;
+        /**
+         * @brief The cached tiles between each pair of nodes, row by row.
+         * Empty until the path is needed.
+        */
+        std::vector<std::vector<sf::Vector2i>> paths;
+        bool dirty = true;
+    };
+    /**
+     * @struct SearchNode
+     * @brief An entry in the open list of the abstract search.
+    */
+    struct SearchNode {
+        uint32_t id;
+        uint32_t cost;
+        uint32_t estimate;
+        inline bool operator>(const SearchNode &other) const { return estimate > other.estimate; }
+    };
+    const ChunkMap &chunk_map;
+    sf::Vector2i chunk_dimensions;
+    std::vector<ChunkGraph> graphs;
+    /**
+     * @brief Scratch buffers for searching from the start and the goal.
+    */
+    std::vector<uint16_t> start_parents, start_distances, goal_parents, goal_distances;
+    /**
+     * @brief Rebuild the nodes and paths of a chunk.
+    */
+    void buildChunk(int chunk_index);
+    /**
+     * @brief Add a node for each entrance along the border between a chunk and
+     * its neighbour in a direction.
+     * @param direction (1, 0), (-1, 0), (0, 1) or (0, -1).
+    */
+    void addEntrances(int chunk_index, const sf::Vector2i &direction, ChunkGraph &graph) const;
+    /**
+     * @brief Breadth-first search within a chunk.
+     * @param chunk_index The chunk to search.
+     * @param source The tile index to search from.
+     * @param parents The previous tile on the path to each tile (out parameter).
+     * @param distances The distance to each tile (out parameter).
+    */
+    void search(int chunk_index, uint16_t source, std::vector<uint16_t> &parents, std::vector<uint16_t> &distances) const;
+    /**
+     * @brief Append the tiles from a source to a target, following the parents
+     * of a search from the source. The source itself isn't appended.
+    */
+    void appendPath(int chunk_index, uint16_t target, const std::vector<uint16_t> &parents, std::vector<sf::Vector2i> &path) const;
+    /**
+     * @brief Get the cached path between two nodes of a chunk.
+    */
+    const std::vector<sf::Vector2i>& getPath(int chunk_index, uint16_t from, uint16_t to);
+    /**
+     * @brief Get the chunk that contains a tile, or -1 if it's outside the world.
+    */
+    int getChunkIndex(const sf::Vector2i &tile) const;
+    /**
+     * @brief Get the index of a tile within its chunk.
+    */
+    static inline uint16_t getLocalIndex(const sf::Vector2i &tile) {
+        return (tile.x % constants::CHUNK_SIZE) + (tile.y % constants::CHUNK_SIZE) * constants::CHUNK_SIZE;
+    }
+    /**
+     * @brief Get the world position of a tile within a chunk.
+    */
+    sf::Vector2i getTile(int chunk_index, uint16_t local_index) const;
+    /**
+     * @brief Pack a chunk and a node into a single id for the abstract search.
+    */
+    static inline uint32_t getNodeId(int chunk_index, uint16_t node) { return (static_cast<uint32_t>(chunk_index) << 16) | node; }
+};
+
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <cstdint>
+
+#include "engine/mobile_object.hpp"
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class SweepAndPrune
+ * @brief Broadphase for collisions between mobile objects.
+ *
+ * The start and end of each object's AABB along the x axis are kept in a
+ * sorted list of endpoints. Objects barely move between two ticks, so the
+ * list is almost sorted already, and insertion sort fixes it in close to
+ * linear time. Every time two endpoints swap places, the pair of objects
+ * either starts or stops overlapping along the x axis, so the set of
+ * overlapping pairs can be kept up to date from the swaps alone, rather
+ * than being rebuilt from scratch every tick.
+ *
+ * The cached pairs only overlap along the x axis, so they still have to be
+ * checked with an actual intersection test before being resolved.
+*/
+class SweepAndPrune {
+public:
+    /**
+     * @brief A pair of mobile objects whose AABBs overlap along the x axis.
+    */
+    using Pair = std::pair<MobileObject*, MobileObject*>;
+    /**
+     * @brief Add an object to the broadphase.
+     * The pairs of the object are found on the next update.
+     * @param object The object to add.
+    */
+    void insert(MobileObject *object);
+    /**
+     * @brief Remove an object from the broadphase.
+     * Does nothing if the object isn't in the broadphase.
+     * @param object The object to remove.
+    */
+    void remove(MobileObject *object);
+    /**
+     * @brief Re-sort the endpoints after the objects have moved.
+     * This also updates the cached pairs.
+    */
+    void update();
+    /**
+     * @brief Get the pairs of objects that overlap along the x axis.
+     * @param pairs The pairs (out parameter).
+     * The pairs are cleared before the new pairs are added.
+    */
+    void getPairs(std::vector<Pair> &pairs) const;
+    /**
+     * @brief Get the number of objects in the broadphase.
+    */
+    inline std::size_t size() const { return proxy_ids.size(); }
+private:
+    /**
+     * @struct Endpoint
+     * @brief The start or the end of an object's AABB along the x axis.
+    */
+    struct Endpoint {
+        float value;
+        uint32_t proxy;
+        bool is_min;
+    };
+    /**
+     * @brief The endpoints of all objects, sorted by value.
+    */
+    std::vector<Endpoint> endpoints;
+    /**
+     * @brief The object each proxy refers to.
+     * Removed proxies are set to nullptr and reused by the next insert.
+    */
+    std::vector<MobileObject*> proxies;
+    /**
+     * @brief Removed proxies that can be reused.
+    */
+    std::vector<uint32_t> free_proxies;
+    /**
+     * @brief The proxy of each object.
+    */
+    std::unordered_map<MobileObject*, uint32_t> proxy_ids;
+    /**
+     * @brief The pairs of proxies that overlap along the x axis.
+     * See getPairKey().
+    */
+    std::unordered_set<uint64_t> pairs;
+    /**
+     * @brief Pack a pair of proxies into a single key.
+     * The order of the proxies doesn't matter.
+    */
+    static inline uint64_t getPairKey(uint32_t a, uint32_t b) {
+        return a < b ? (static_cast<uint64_t>(a) << 32) | b : (static_cast<uint64_t>(b) << 32) | a;
+    }
+    /**
+     * @brief Get the current value of an endpoint from the AABB of its object.
+    */
+    float getValue(const Endpoint &endpoint) const;
+};
+
+} // namespace engine
+} // namespace rpg
@@ -33,7 +33,11 @@ public:
     /**
      * @brief Get the vertices of the tile.
     */
-    const std::vector<sf::Vertex>& getVertices() const;
+    const resources::VertexQuad::Vertices& getVertices() const;
+    /**
+     * @brief Get the page of the texture atlas the tile is drawn with.
+    */
+    inline uint32_t getPage() const { return vertex_quad.getPage(); }
      /**
      * @brief Get the position of the tile.
     */
@@ -49,6 +53,12 @@ public:
      * See resources::ConnectedTexture::Neighbours for more information.
     */
     void connectTexture(resources::connected_textures::ConnectedTexture::Neighbours neighbours);
+    /**
+     * @brief Copy the texture of the tile from the resource manager again.
+     * The tile keeps its variation and its neighbours. This is needed after
+     * the texture atlas was repacked, see World::refreshTextures().
+    */
+    void refreshTexture();
 protected:
     /**
      * @brief The name of the tile in the game registry, e.g. "tile.grass".
@@ -70,6 +80,19 @@ protected:
      * @brief The variations of the tile.
     */
     std::shared_ptr<resources::WeightedTexture> variations = nullptr;
+    /**
+     * @brief The texture of the tile, see refreshTexture().
+    */
+    resources::TextureId texture_id = resources::ResourceManager::INVALID_TEXTURE_ID;
+    /**
+     * @brief The index of the variation the tile is drawn with, if it has variations.
+    */
+    int variation = 0;
+    /**
+     * @brief The neighbours the texture was last connected to, if it was.
+    */
+    resources::connected_textures::ConnectedTexture::Neighbours neighbours{};
+    bool connected = false;
 };
 
 } // namespace engine
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <functional>
+
+#include "engine/tile.hpp"
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @class TileVertexWindow
+ * @brief Ring buffer of the vertices of the tiles covered by the view.
+ *
+ * The window is a fixed size grid of tiles that is just large enough to cover
+ * the view. Tile (x, y) is always stored in slot (x mod width, y mod height),
+ * so when the view scrolls the tiles that are still visible keep their slot,
+ * and only the row or column that was scrolled into view has to be rebuilt.
+ * The vertices are in world coordinates, so scrolling by less than a tile
+ * is handled entirely by the view transform.
+ *
+ * There is one ring buffer per page of the texture atlas that any of the
+ * tiles have been on. A tile is written to the buffer of its page, and its
+ * slot is collapsed in all the others.
+*/
+class TileVertexWindow : public sf::Drawable {
+public:
+    /**
+     * @brief Function used to look up a tile in the world.
+     * Should return nullptr if there is no tile at the given position.
+    */
+    using TileGetter = std::function<const Tile*(int x, int y)>;
+    /**
+     * @brief Update the window to cover a view.
+     * If the view has only moved, only the newly exposed tiles are rebuilt.
+     * If the size of the view has changed, the whole window is rebuilt.
+     * @param view The view the window should cover.
+     * @param get_tile Function used to look up the tiles.
+    */
+    void update(const sf::View &view, const TileGetter &get_tile);
+    /**
+     * @brief Force the whole window to be rebuilt on the next update.
+     * This should be called whenever the tiles in the world change.
+    */
+    inline void invalidate() { dirty = true; }
+    /**
+     * @brief Draw the tiles in the window.
+     * The texture is set by the window, one draw call per page of the texture atlas.
+    */
+    virtual void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
+private:
+    /**
+     * @brief The vertices of the window (4 per tile), per page of the texture atlas.
+     * The slots are stored row by row, see TileVertexWindow.
+    */
+    std::vector<std::vector<sf::Vertex>> pages;
+    /**
+     * @brief The world position of the top left tile in the window.
+    */
+    sf::Vector2i origin;
+    /**
+     * @brief The size of the window (in tiles).
+    */
+    sf::Vector2i size;
+    /**
+     * @brief Whether or not the whole window has to be rebuilt.
+    */
+    bool dirty = true;
+    /**
+     * @brief Rebuild the slot for a tile.
+     * @param x The x coordinate of the tile in the world.
+     * @param y The y coordinate of the tile in the world.
+     * @param get_tile Function used to look up the tile.
+    */
+    void buildTile(int x, int y, const TileGetter &get_tile);
+    /**
+     * @brief Rebuild a rectangle of tiles.
+     * The rectangle is given in world coordinates.
+    */
+    void buildRect(int x_start, int y_start, int x_end, int y_end, const TileGetter &get_tile);
+};
+
+} // namespace engine
+} // namespace rpg
@@ -39,6 +39,10 @@ public:
      * @param delta_time Time elapsed since the last frame.
     */
     void update(float delta_time) override;
+    /**
+     * @brief Refresh the textures of the list and of the buttons in it.
+    */
+    void refreshTextures() override;
     void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
     void drawDebug(sf::RenderTarget &target, sf::RenderStates states) const override;
     void show() override;
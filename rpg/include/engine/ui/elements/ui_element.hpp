@@ -5,9 +5,11 @@
 #include "engine/aabb.hpp"
 #include "resources/connected_textures/connected_texture.hpp"
 #include "resources/vertex_quad.hpp"
+#include "resources/resource_manager.hpp"
 
 #include <functional>
 #include <memory>
+#include <array>
 
 namespace rpg {
 namespace engine {
@@ -49,6 +51,11 @@ public:
      * @param delta_time The time since the last frame.
     */
     virtual void update(float delta_time);
+    /**
+     * @brief Copy the rects of the current state out of the resource manager again.
+     * This is needed after the texture atlas was repacked.
+    */
+    virtual void refreshTextures();
     /**
      * @brief Move the element.
      * @param offset The offset to move the element by.
@@ -100,6 +107,11 @@ protected:
      * This is used to connect the sprites to each other.
     */
     std::shared_ptr<resources::connected_textures::ConnectedTexture> connected_texture;
+    /**
+     * @brief The ids of the connected textures for each state, see State.
+     * These are looked up once, so changing the state doesn't look anything up by name.
+    */
+    std::array<resources::TextureId, 3> connected_texture_ids;
     /**
      * @brief The neighbours of each sprite in the grid.
      * This is used to connect the sprites to each other.
@@ -48,6 +48,10 @@ public:
     */
     sf::Vector2f getMousePos() const;
     void update(float delta_time);
+    /**
+     * @brief Refresh the textures of every UI element, see UIElement::refreshTextures().
+    */
+    void refreshTextures();
     void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
     void drawDebug(sf::RenderTarget &target, sf::RenderStates states) const override;
     /**
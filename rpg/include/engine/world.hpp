@@ -5,9 +5,21 @@
 #include <array>
 #include <memory>
 #include <set>
+#include <unordered_map>
+#include <string>
 #include "engine/game_object.hpp"
 #include "engine/player.hpp"
 #include "engine/drawable_debug.hpp"
+#include "engine/tile_vertex_window.hpp"
+#include "engine/sweep_and_prune.hpp"
+#include "engine/chunk_map.hpp"
+#include "engine/path_finder.hpp"
+#include "engine/flow_field.hpp"
+#include "engine/animation_table.hpp"
+#include "engine/object_pool.hpp"
+#include "engine/ecs/registry.hpp"
+#include "engine/ecs/tick_scheduler.hpp"
+#include "engine/ecs/draw_order.hpp"
 
 namespace rpg {
 namespace engine {
@@ -30,6 +42,14 @@ public:
      * @param delta The time since the last update.
     */
     void update(float delta);
+    /**
+     * @brief Interpolate the world between the last two simulation ticks.
+     * The mobile objects (and the view) are drawn at their interpolated
+     * positions, so movement looks smooth regardless of the tick rate.
+     * @param alpha How far we are between the previous and the next
+     * simulation tick, in the range [0, 1].
+    */
+    void interpolate(float alpha);
     /**
      * @brief Draw the world.
      * 
@@ -49,13 +69,39 @@ public:
     */
     void createTile(const sf::Vector2i& position, const std::string &registry_name);
     /**
-     * @brief Create a game object.
+     * @brief Create a static game object.
+     * The object is stored in the chunk map, and is part of the world from the next update.
      * @param position The position of the game object.
      * @param registry_name The name of the game object in the game registry.
     */
     void createGameObject(const sf::Vector2i& position, const std::string &registry_name);
-    
-    // TODO: createEntity
+    /**
+     * @brief Create a mobile object.
+     * @param position The position of the mobile object.
+     * @param registry_name The name of the object in the game registry.
+     * @return The handle of the object.
+    */
+    ObjectHandle createMobileObject(const sf::Vector2i& position, const std::string &registry_name);
+    /**
+     * @brief Destroy a mobile object.
+     * Does nothing if the object has already been destroyed.
+     * @param handle The handle of the object.
+    */
+    void destroyMobileObject(ObjectHandle handle);
+    /**
+     * @brief Spawn many lightweight entities of the same type at once.
+     * The registry data and the animation table are looked up once for the
+     * whole batch, and the entities are simulated by the ECS systems (see
+     * getRegistry()). Animated entities switch between their walk and idle
+     * animations as they move, like an Entity.
+     * @param registry_name The name of the entity in the game registry, e.g. "entity.slime".
+     * @param positions The positions of the entities (the top left corner of their sprites).
+     * @param entities The handles of the new entities, in the same order as the positions (out parameter).
+     * The handles are appended, so several batches can be collected together.
+     * @param chase_player Whether or not the entities follow the flow field towards the player.
+    */
+    void spawnEntities(const std::string &registry_name, const std::vector<sf::Vector2f> &positions,
+        std::vector<ecs::EntityHandle> &entities, bool chase_player = true);
 
     /**
      * @brief Create the player.
@@ -67,11 +113,47 @@ public:
      * @return The player.
     */
     inline Player& getPlayer() const { return *player; }
+    /**
+     * @brief Get the registry of the lightweight entities.
+     * Entities created here are updated and drawn by the world's systems.
+    */
+    inline ecs::Registry& getRegistry() { return registry; }
+    /**
+     * @brief Find a walkable path between two tiles.
+     * See PathFinder::findPath().
+     * @param start The tile to start at.
+     * @param goal The tile to end at.
+     * @param path The tiles along the path, including the start and the goal (out parameter).
+     * @return True if a path was found, false otherwise.
+    */
+    inline bool findPath(const sf::Vector2i &start, const sf::Vector2i &goal, std::vector<sf::Vector2i> &path) { return path_finder.findPath(start, goal, path); }
+    /**
+     * @brief Get the flow field towards the player.
+     * Mobile objects chasing the player can use this to set their direction.
+    */
+    inline const FlowField& getFlowField() const { return flow_field; }
+    /**
+     * @brief Get the chunk map, which knows which tiles are solid.
+    */
+    inline const ChunkMap& getChunkMap() const { return chunk_map; }
     /**
      * @brief Update the view.
+     * This also scrolls the tile vertex window to cover the new view.
      * @param view The view to update.
     */
-    void updateView(sf::View &view) const;
+    void updateView(sf::View &view);
+    /**
+     * @brief Make the animated entities pick up clips that were hot reloaded.
+     * @param clip_ids The ids of the clips that changed, see GameRegistry::pollHotReload().
+    */
+    void refreshAnimations(const std::vector<resources::AnimationClipId> &clip_ids);
+    /**
+     * @brief Copy every texture rect out of the resource manager again, after
+     * the texture atlas was repacked (see GameRegistry::pollHotReload()).
+     * This covers the tiles, the static objects (which are baked again), the
+     * mobile objects and the lightweight entities with a Sprite.
+    */
+    void refreshTextures();
 private:
     /**
      * @brief The game registry.
@@ -88,6 +170,8 @@ private:
     int seed;
     /**
      * @brief The border of the world.
+     * This is only drawn for debugging. Objects are kept inside the world by
+     * the chunk map, which treats everything outside the world as solid.
     */
     std::array<AABB, 4> world_border;
     /**
@@ -96,21 +180,107 @@ private:
     std::unique_ptr<Player> player;
     // change to shared_ptr when chunks are implemented
     std::vector<Tile> tiles;
-    // change to shared_ptr when chunks are implemented
-    // maybe also split into dynamic and static objects
-    std::vector<std::shared_ptr<GameObject>> game_objects;
+    /**
+     * @brief The chunks of the world.
+     * This is where the solidity of the tiles and the static objects are stored.
+    */
+    ChunkMap chunk_map;
+    /**
+     * @brief Pathfinding over the tiles of the chunk map.
+    */
+    PathFinder path_finder;
+    /**
+     * @brief Directions towards the player, used by everything chasing the player.
+    */
+    FlowField flow_field;
+    /**
+     * @brief The vertices of the tiles covered by the view.
+    */
+    TileVertexWindow tile_window;
+    /**
+     * @brief The objects that can move.
+     * These are updated every tick, unlike the static objects, which are
+     * stored in the chunk map.
+    */
+    ObjectPool<MobileObject> mobile_objects;
+    /**
+     * @brief The mobile objects (including the player), sorted by y position.
+     * These are merged with the static objects of the chunks when drawing.
+    */
     std::vector<GameObject*> drawables;
+    /**
+     * @brief The lightweight entities, stored as components.
+     * These are meant for large crowds (mobs, critters etc.) that don't need
+     * the full behaviour of an Entity. See ecs/systems.hpp.
+    */
+    ecs::Registry registry;
+    /**
+     * @brief Decides which of the lightweight entities are updated each tick.
+    */
+    ecs::TickScheduler tick_scheduler;
+    /**
+     * @brief The animation tables of the kinds of lightweight entities, see ecs::Animator.
+    */
+    std::vector<AnimationTable> animation_tables;
+    /**
+     * @brief The index in animation_tables of each kind, by registry name.
+    */
+    std::unordered_map<std::string, uint32_t> animation_table_ids;
+    /**
+     * @brief Scratch buffer for the chunks found when resolving collisions.
+     * Kept around so that we don't allocate a new vector for every object.
+    */
+    std::vector<const Chunk*> collision_chunks;
+    /**
+     * @brief Scratch buffers for draw(), kept around so that drawing a frame
+     * doesn't allocate: the visible chunks, the next static object to draw in
+     * each of them, and the vertices of the current batch.
+    */
+    mutable std::vector<const Chunk*> draw_chunks;
+    mutable std::vector<std::size_t> draw_cursors;
+    mutable sf::VertexArray draw_vertices;
+    /**
+     * @brief The lightweight entities sorted by y, kept from one frame to the
+     * next since they're almost sorted already.
+    */
+    mutable ecs::DrawOrder draw_order;
+    /**
+     * @brief Broadphase for collisions between mobile objects (including the player).
+    */
+    SweepAndPrune sweep_and_prune;
+    /**
+     * @brief Scratch buffer for the pairs found by the sweep and prune.
+    */
+    std::vector<SweepAndPrune::Pair> collision_pairs;
     /**
      * @brief The time since the last update.
      * Mainly used for calculating the FPS.
     */
     float last_delta = 0.0f;
+    /**
+     * @brief How far we are between the previous and the next simulation tick.
+     * See World::interpolate.
+    */
+    float interpolation_alpha = 1.0f;
     /**
      * @brief Check if a point is in the world.
      * @param point The point.
      * @return Whether or not the point is in the world.
     */
     bool isPointInWorld(const sf::Vector2f &point) const;
+    /**
+     * @brief Resolve the collisions between a mobile object and the static world.
+     * Only the static objects in the nearby chunks are checked.
+     * Collisions with other mobile objects are handled by the sweep and prune.
+     * @param mobile_object The mobile object.
+    */
+    void resolveCollisions(MobileObject &mobile_object);
+    /**
+     * @brief Get the animation table of a kind of lightweight entity, creating it the first time.
+     * @param data The data of the entity.
+     * @return The index in animation_tables.
+    */
+    uint32_t getAnimationTable(const resources::GameRegistry::EntityData &data);
     /**
      * @brief Get a tile at a position.
      * @param position The position of the tile.
@@ -136,12 +306,6 @@ private:
      * @return The viewport.
     */
     sf::FloatRect getViewport(const sf::View &view) const;
-    /**
-     * @brief Get the visible tiles.
-     * @param viewport The viewport.
-     * @return The visible tiles.
-    */
-    std::vector<const Tile*> getVisibleTiles(const sf::FloatRect &viewport) const;
 
     // ####################
     // # WORLD GENERATION #
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <SFML/Graphics.hpp>
+
+#include "resources/resource_ids.hpp"
+
+namespace rpg {
+namespace resources {
+
+/**
+ * @class AnimationClip
+ * @brief An animation clip is a collection of frames.
+ *
+ * Each frame is an sf::IntRect that specifies a rectangle in a texture.
+ * The animation is played by looping through the frames at a specified frame rate.
+ *
+ * A clip is loaded once and shared by everything that plays it, so it doesn't
+ * keep track of the current frame. That is done by an AnimationPlayer.
+ *
+ * @todo: SpriteCollecion base class?
+*/
+class AnimationClip {
+public:
+    /**
+     * @brief Marks a missing clip.
+    */
+    static constexpr AnimationClipId INVALID_ID{};
+    /**
+     * @brief Construct an animation clip.
+     * @param frames The frames of the animation.
+     * @param frame_rate The frame rate of the animation.
+     * The frame rate is the number of frames per second.
+     * @param loop Whether or not the animation should loop.
+     * This is optional and defaults to true.
+    */
+    AnimationClip(const std::vector<sf::IntRect> &frames, int frame_rate, bool loop = true);
+    /**
+     * @brief Get the index of the frame that is shown at a point in time.
+     * @param time The time since the animation started.
+     * @return The index of the frame.
+     * Clips that don't loop stay on their last frame.
+    */
+    std::size_t getFrameIndex(float time) const;
+    /**
+     * @brief Get the frame that is shown at a point in time.
+     * @param time The time since the animation started.
+     * @return The frame.
+    */
+    inline const sf::IntRect& getFrame(float time) const { return frames[getFrameIndex(time)]; }
+    /**
+     * @brief Get all frames.
+     * @return The frames.
+    */
+    const std::vector<sf::IntRect>& getFrames() const { return frames; }
+    /**
+     * @brief Get the frame rate (frames per second).
+    */
+    inline float getFrameRate() const { return frame_rate; }
+    /**
+     * @brief Check if the animation loops.
+    */
+    inline bool isLooping() const { return loop; }
+    /**
+     * @brief Get the time it takes to play every frame once.
+    */
+    inline float getDuration() const { return frames.size() / frame_rate; }
+    /**
+     * @brief Move the animation to a position.
+     * This is only used while building the texture atlas.
+     * @param position The position to move the animation to.
+     * The position is the top left corner of the animation.
+     * The position is relative to the texture atlas.
+    */
+    void moveTo(const sf::Vector2f &position);
+    /**
+     * @brief Set the page of the texture atlas the frames are on.
+     * This is only used while building the texture atlas.
+    */
+    inline void setPage(uint32_t page) { this->page = page; }
+    /**
+     * @brief Get the page of the texture atlas the frames are on.
+    */
+    inline uint32_t getPage() const { return page; }
+private:
+    /**
+     * @brief The frames of the animation.
+     * The frames are sf::IntRects that specify a rectangle in a texture.
+     * The frames are relative to the texture atlas.
+    */
+    std::vector<sf::IntRect> frames;
+    /**
+     * @brief The frame rate of the animation.
+     * The frame rate is the number of frames per second.
+    */
+    float frame_rate;
+    /**
+     * @brief Whether or not the animation should loop.
+    */
+    bool loop;
+    /**
+     * @brief The page of the texture atlas the frames are on.
+    */
+    uint32_t page = 0;
+};
+
+} // namespace resources
+} // namespace rpg
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "resources/animation_clip.hpp"
+
+namespace rpg {
+namespace resources {
+
+/**
+ * @class AnimationPlayer
+ * @brief The playback state of an animation clip.
+ *
+ * Every entity that is animated has its own player, while the clips themselves
+ * are shared. A player only stores the id of its clip and how long it has been
+ * playing, so it's cheap to have lots of them.
+*/
+class AnimationPlayer {
+public:
+    AnimationPlayer() = default;
+    /**
+     * @brief Construct a player that starts playing a clip.
+     * @param clip The id of the clip.
+    */
+    explicit AnimationPlayer(AnimationClipId clip) : clip(clip) {}
+    /**
+     * @brief Play a clip.
+     * The clip only starts over if it isn't already playing.
+     * @param clip The id of the clip.
+    */
+    void play(AnimationClipId clip);
+    /**
+     * @brief Advance the playback.
+     * @param clip The clip that is playing, see getClip().
+     * @param dt The time since the last update.
+    */
+    void advance(const AnimationClip &clip, float dt);
+    /**
+     * @brief Get the current frame.
+     * @param clip The clip that is playing, see getClip().
+     * @return The current frame.
+    */
+    inline const sf::IntRect& getFrame(const AnimationClip &clip) const { return clip.getFrame(time); }
+    /**
+     * @brief Get the id of the clip that is playing.
+     * @return The id, or AnimationClip::INVALID_ID if nothing is playing.
+    */
+    inline AnimationClipId getClip() const { return clip; }
+    /**
+     * @brief Get the time since the clip started.
+    */
+    inline float getTime() const { return time; }
+private:
+    AnimationClipId clip = AnimationClip::INVALID_ID;
+    float time = 0;
+};
+
+} // namespace resources
+} // namespace rpg
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <filesystem>
+#include <type_traits>
+#include <cstring>
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "resources/virtual_file_system.hpp"
+
+namespace rpg {
+namespace resources {
+
+/**
+ * An asset pack holds everything the game would otherwise load from the
+ * resources folder at startup: the pages of the texture atlas (as raw pixels),
+ * the rects of every texture, animation, variation and connected texture in
+ * the atlas, and the tile/object/entity data from the json files. It's written
+ * by the rpg_assetbake tool (see src/tools/asset_bake.cpp), so the game never
+ * has to decode an image or pack the atlas itself.
+ *
+ * The pack is a flat sequence of values in the byte order of the machine that
+ * baked it. Strings are prefixed with their length, and the atlas pixels are
+ * aligned so they can be uploaded straight from the mapped file. The order of
+ * the sections is defined by ResourceManager::savePack() and
+ * GameRegistry::savePack(), and the matching loadPack() functions. The first
+ * value is the key of the files the pack was baked from, which the atlas cache
+ * is checked against (see GameRegistry::computeCacheKey()). It's followed by the
+ * path, size and modification time of each of those files, so the game can tell
+ * if the resources folder has changed since without reading any of them.
+ *
+ * The archives of the VirtualFileSystem are written and read the same way,
+ * just with a magic and version of their own.
+*/
+
+/**
+ * @class AssetPackWriter
+ * @brief Builds an asset pack in memory, and saves it to a file.
+*/
+class AssetPackWriter {
+public:
+    /**
+     * @brief Identifies a file as an asset pack.
+    */
+    static constexpr uint32_t MAGIC = 0x50475052; // "RPGP"
+    /**
+     * @brief Must be increased whenever the layout of the pack changes.
+    */
+    static constexpr uint32_t VERSION = 4;
+    /**
+     * @brief Start a new pack with the header already written.
+     * @param magic Identifies the kind of file, MAGIC for an asset pack.
+     * @param version The version of the layout, VERSION for an asset pack.
+    */
+    AssetPackWriter(uint32_t magic = MAGIC, uint32_t version = VERSION);
+    /**
+     * @brief Write a plain value, e.g. an int or a float.
+    */
+    template <typename T>
+    void write(const T &value) {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written directly");
+        writeBytes(&value, sizeof(T));
+    }
+    void writeString(const std::string &value);
+    void writeRect(const sf::IntRect &rect);
+    void writeBytes(const void *data, std::size_t size);
+    /**
+     * @brief Pad the pack with zeros up to a multiple of an alignment.
+    */
+    void align(std::size_t alignment);
+    /**
+     * @brief Save the pack to a file.
+     * @throws std::runtime_error if the file can't be written.
+    */
+    void save(const std::filesystem::path &path) const;
+private:
+    std::vector<uint8_t> buffer;
+};
+
+/**
+ * @class AssetPackReader
+ * @brief Reads the values of an asset pack in the order they were written.
+ * The file is mapped into memory rather than read, see MappedFile, and can
+ * also come from the VirtualFileSystem (e.g. a pack inside an archive).
+*/
+class AssetPackReader {
+public:
+    /**
+     * @brief Open an asset pack and check its header.
+     * @param path The path to the pack.
+     * @throws std::runtime_error if the file isn't a pack, or was baked for another version.
+    */
+    AssetPackReader(const std::filesystem::path &path);
+    /**
+     * @brief Read a pack that is already open and check its header.
+     * @param file The contents of the pack.
+     * @param name The name of the pack, for error messages.
+     * @param magic The magic the file should start with, see AssetPackWriter().
+     * @param version The version the file should have, see AssetPackWriter().
+     * @throws std::runtime_error if the file doesn't match the magic or the version.
+    */
+    AssetPackReader(const VirtualFileSystem::File &file, const std::string &name,
+                    uint32_t magic = AssetPackWriter::MAGIC, uint32_t version = AssetPackWriter::VERSION);
+    /**
+     * @brief Read a plain value, e.g. an int or a float.
+     * @throws std::runtime_error if the pack ends before the value.
+    */
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read directly");
+        T value;
+        std::memcpy(&value, readBytes(sizeof(T)), sizeof(T));
+        return value;
+    }
+    std::string readString();
+    sf::IntRect readRect();
+    /**
+     * @brief Read a number of bytes without copying them.
+     * @return A pointer into the mapped file, valid as long as the reader.
+     * @throws std::runtime_error if the pack ends before the bytes.
+    */
+    const uint8_t* readBytes(std::size_t size);
+    /**
+     * @brief Skip the padding written by AssetPackWriter::align().
+    */
+    void align(std::size_t alignment);
+    /**
+     * @brief Get the number of bytes read so far.
+    */
+    inline std::size_t getOffset() const { return offset; }
+private:
+    VirtualFileSystem::File file;
+    std::size_t offset = 0;
+};
+
+} // namespace resources
+} // namespace rpg
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <cstdint>
 
 namespace rpg {
 namespace resources {
@@ -43,6 +44,14 @@ public:
      * The position is relative to the texture atlas.
     */
     void moveTo(const sf::Vector2f &position);
+    /**
+     * @brief Set the page of the texture atlas the rects are on.
+    */
+    inline void setPage(uint32_t page) { this->page = page; }
+    /**
+     * @brief Get the page of the texture atlas the rects are on.
+    */
+    inline uint32_t getPage() const { return page; }
     /**
      * @brief Get the rect that corresponds to the given neighbours.
      * @param neighbours The neighbours of the tile. See ConnectedTexture::Neighbours.
@@ -68,6 +77,10 @@ protected:
      * Each sprite is an sf::IntRect that specifies a rectangle in the texture atlas.
     */
     std::vector<sf::IntRect> rects;
+    /**
+     * @brief The page of the texture atlas the rects are on.
+    */
+    uint32_t page = 0;
 };
 
 } // namespace connected_textures
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <filesystem>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <chrono>
+
+namespace rpg {
+namespace resources {
+
+/**
+ * @class FileWatcher
+ * @brief Reports the files in a folder (and its subfolders) that have been written to.
+ *
+ * On Linux the watcher is built on inotify, so nothing is scanned, and a file
+ * is reported as soon as whatever wrote it closes it (or renames it into place,
+ * which is how a lot of editors save). Everywhere else the folder is scanned
+ * for new modification times every POLL_INTERVAL instead.
+*/
+class FileWatcher {
+public:
+    /**
+     * @brief Start watching a folder.
+     * Subfolders that are created after this aren't watched.
+     * @param root The folder to watch.
+     * @throws std::runtime_error if the folder can't be watched.
+    */
+    FileWatcher(const std::filesystem::path &root);
+    ~FileWatcher();
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+    /**
+     * @brief Get the files that were written since the last call, without blocking.
+     * Each file is only reported once per call, however often it was written.
+     * @param changed Receives the paths of the files.
+    */
+    void poll(std::vector<std::filesystem::path> &changed);
+private:
+    std::filesystem::path root;
+#ifdef __linux__
+    int inotify_descriptor = -1;
+    /**
+     * @brief The folder of each inotify watch.
+    */
+    std::unordered_map<int, std::filesystem::path> watches;
+#else
+    /**
+     * @brief How often the folder is scanned.
+    */
+    static constexpr std::chrono::milliseconds POLL_INTERVAL{250};
+    std::chrono::steady_clock::time_point next_scan;
+    /**
+     * @brief The last modification time of each file.
+    */
+    std::unordered_map<std::string, std::filesystem::file_time_type> write_times;
+    /**
+     * @brief Scan the folder for files with a new modification time.
+     * @param changed Receives the paths of the files, or nullptr to only record the times.
+    */
+    void scan(std::vector<std::filesystem::path> *changed);
+#endif
+};
+
+} // namespace resources
+} // namespace rpg
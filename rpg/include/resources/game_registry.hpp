@@ -6,6 +6,8 @@
 #include <iostream>
 
 #include "resources/resource_manager.hpp"
+#include "resources/file_watcher.hpp"
+#include "resources/virtual_file_system.hpp"
 #include "engine/aabb.hpp"
 
 namespace rpg {
@@ -29,6 +31,7 @@ public:
     static GameRegistry& getInstance();
     
     static constexpr const char* TILE_PREFIX = "tile";
+    static constexpr const char* TILE_JSON_SUFFIX = ".tile.json";
     /**
      * @brief The data needed to construct a tile.
     */
@@ -38,6 +41,21 @@ public:
          * The name has be unique. If the name already exists, the tile will not be registered.
         */
         std::string registry_name;
+        /**
+         * Whether or not the tile is solid, i.e. can't be walked on. This is optional.
+         * If the tile doesn't have a json file, the tile is not solid.
+        */
+        bool solid = false;
+        /**
+         * The id of the texture, looked up once so that creating a tile doesn't
+         * have to look anything up by name, see ResourceManager::getTextureId().
+        */
+        TextureId texture_id = ResourceManager::INVALID_TEXTURE_ID;
+        /**
+         * The id of the connected texture, or ResourceManager::INVALID_TEXTURE_ID
+         * if there isn't one, see ResourceManager::getConnectedTextureId().
+        */
+        TextureId connected_texture_id = ResourceManager::INVALID_TEXTURE_ID;
     };
     TileData createTileData(const std::string &name, const std::string &prefix);
     TileData getTileData(const std::string &name) const;
@@ -71,7 +89,7 @@ public:
          * If no maximum health is provided, the maximum health will default to MAX_HEALTH_DEFAULT.
         */
         unsigned int max_health = MAX_HEALTH_DEFAULT;
-        std::map<std::string, Animation&> animations;
+        std::map<std::string, AnimationClipId> animations;
     };
     EntityData createEntityData(const std::string &name, const std::string &prefix);
     EntityData getEntityData(const std::string &name) const;
@@ -98,18 +116,181 @@ public:
     inline sf::Font& getFont() { return font; }
 
     inline void buildTextureAtlas() { resource_manager.buildTextureAtlas(); }
-    inline const sf::Texture& getTextureAtlas() { return resource_manager.getTextureAtlas(); }
+    inline const sf::Texture& getTextureAtlas(uint32_t page = 0) { return resource_manager.getTextureAtlas(page); }
+    inline std::size_t getTextureAtlasPageCount() { return resource_manager.getTextureAtlasPageCount(); }
 
     /**
      * @brief Get the path to the resources folder.
+     * This is the root of the VirtualFileSystem, so it can also be an archive,
+     * see VirtualFileSystem::writeArchive(). Unless setResourcesFolder() was
+     * called, it's the RPG_RESOURCES environment variable if it's set, or the
+     * resources folder next to the source code otherwise.
      * @return The path to the resources folder.
     */
     static std::string getResourcesFolder();
+    /**
+     * @brief Choose where the resources are loaded from.
+     * Must be called before the first call to getInstance().
+     * @param path The path to the resources folder, or an archive of it.
+    */
+    static inline void setResourcesFolder(const std::string &path) { GameRegistry::resources_folder = path; }
+    /**
+     * @brief Get the path to the asset pack, see asset_pack.hpp.
+    */
+    static std::filesystem::path getPackPath();
+    /**
+     * @brief Choose whether or not the registry loads from the asset pack (if there is one).
+     * A pack in a folder is only loaded if it was baked from the files that are
+     * in the folder now, otherwise the folder (or the atlas cache) is loaded
+     * instead. A pack in an archive is always loaded.
+     * Must be called before the first call to getInstance(). The asset bake
+     * tool turns this off, so it always loads from the resources folder.
+    */
+    static inline void setUsePack(bool use_pack) { GameRegistry::use_pack = use_pack; }
+    /**
+     * @brief Choose whether or not the registry uses the atlas cache.
+     * Without an asset pack, everything is loaded from the resources folder and
+     * then cached in the cache folder, keyed by the contents of the files. The
+     * next launch loads the cache instead, unless one of the files changed.
+     * Must be called before the first call to getInstance().
+    */
+    static inline void setUseCache(bool use_cache) { GameRegistry::use_cache = use_cache; }
+    /**
+     * @brief Get the path to the folder the atlas cache is kept in.
+    */
+    static std::filesystem::path getCacheFolder();
+    /**
+     * @brief Save everything that has been registered to an asset pack.
+     * The game loads the pack at startup instead of the resources folder.
+     * @param path The path to the pack.
+     * @throws std::runtime_error if the pack can't be written.
+    */
+    void savePack(const std::filesystem::path &path) const;
+    /**
+     * @brief Start watching the resources folder for changes, see pollHotReload().
+     * Failing to watch the folder isn't fatal, the game just won't hot reload.
+    */
+    void enableHotReload();
+    /**
+     * @brief Reload the textures, animations and variations that changed on disk.
+     * Textures are decoded on a job and patched into the texture atlas by a
+     * later call, and animations and variations are updated in place, so
+     * nothing has to be registered again. A texture that no longer fits in its
+     * rect is repacked into the atlas on a job (see
+     * ResourceManager::reloadTexture()), which a later call swaps in. The tile,
+     * object and entity json files aren't reloaded.
+     * Does nothing unless enableHotReload() was called.
+     * @param reloaded_clips Receives the ids of the animation clips that changed,
+     * so anything that copied them can refresh them.
+     * @return True if the texture atlas was repacked, so anything that copied
+     * a rect out of it has to copy it again (see World::refreshTextures()).
+    */
+    bool pollHotReload(std::vector<AnimationClipId> &reloaded_clips);
 
     GameRegistry(GameRegistry const&) = delete;
     void operator=(GameRegistry const&) = delete;
 private:
     GameRegistry();
+    /**
+     * @struct SourceFile
+     * @brief A file an asset pack was baked from, as it was on disk at the time.
+     * Every pack holds a list of these, so telling if a pack in the resources
+     * folder is out of date only takes a stat per file, see listSourceFiles().
+    */
+    struct SourceFile {
+        /**
+         * @brief The path relative to the resources folder, so the folder can be moved.
+        */
+        std::string path;
+        uint64_t size = 0;
+        int64_t write_time = 0;
+        inline bool operator==(const SourceFile &other) const {
+            return path == other.path && size == other.size && write_time == other.write_time;
+        }
+        inline bool operator!=(const SourceFile &other) const { return !(*this == other); }
+    };
+    /**
+     * @brief Load everything from an asset pack instead of the resources folder.
+     * @param reader The pack, right after the header.
+     * @param key The key of the files in the resources folder (see computeCacheKey()),
+     * or empty to skip comparing it.
+     * @param source_files The files in the resources folder (see listSourceFiles()),
+     * or empty to skip comparing them.
+     * @return False if the pack was baked from other files, in which case nothing is loaded.
+    */
+    bool loadPack(AssetPackReader &reader, const std::string &key, const std::vector<SourceFile> &source_files);
+    /**
+     * @brief Find every file that registering the entries could read, i.e. every
+     * file in the folders of the entries, sorted by path.
+     * @param entries The registry names of the entries.
+     * @return The paths to the files.
+    */
+    static std::vector<std::filesystem::path> findSourcePaths(const std::vector<std::string> &entries);
+    /**
+     * @brief Look up the size and modification time of the source files.
+     * This doesn't read any of them, so it's cheap enough to do on every launch.
+     * A file that doesn't exist has a size and modification time of 0.
+     * @param paths The paths to the files, see findSourcePaths().
+     * @return The files, in the same order.
+    */
+    static std::vector<SourceFile> listSourceFiles(const std::vector<std::filesystem::path> &paths);
+    /**
+     * @brief Hash everything that registering the entries would read.
+     * The hash covers the relative path and contents of every source file, the
+     * entries themselves and the version of the asset pack format, but not the
+     * modification times, so touching a file doesn't throw the atlas cache away.
+     * The files are hashed across the job system.
+     * @param entries The registry names of the entries.
+     * @param paths The paths to the files, see findSourcePaths().
+     * @return The hash as a hex string.
+    */
+    static std::string computeCacheKey(const std::vector<std::string> &entries, const std::vector<std::filesystem::path> &paths);
+    /**
+     * @brief Load the atlas cache, if it was built from the same files.
+     * @param key The key of the files, see computeCacheKey().
+     * @return True if the cache was loaded, false if it's missing or out of date.
+    */
+    bool loadCache(const std::string &key);
+    /**
+     * @brief Save everything that has been registered to the atlas cache.
+     * @param key The key of the files, see computeCacheKey().
+     * @param build_milliseconds How long loading from the resources folder took,
+     * so a cache hit can report the time it saved.
+    */
+    void saveCache(const std::string &key, long long build_milliseconds) const;
+    /**
+     * @brief The name of the asset pack in the resources folder.
+    */
+    static constexpr const char* PACK_FILENAME = "assets.pack";
+    static inline bool use_pack = true;
+    /**
+     * @brief See getResourcesFolder().
+    */
+    static inline std::string resources_folder;
+    /**
+     * @brief The names of the files in the cache folder.
+     * The cache is an asset pack, and the index holds the key it was built for.
+    */
+    static constexpr const char* CACHE_FOLDER = ".cache";
+    static constexpr const char* CACHE_PACK_FILENAME = "atlas.pack";
+    static constexpr const char* CACHE_INDEX_FILENAME = "atlas.json";
+    static inline bool use_cache = true;
+    /**
+     * @brief Watches the resources folder, if hot reloading is enabled.
+    */
+    std::unique_ptr<FileWatcher> file_watcher;
+    /**
+     * @brief Get the registry name of the texture a file in the resources folder belongs to.
+     * E.g. "tile/grass.variations.json" belongs to "tile.grass", and
+     * "tile/dirt_connected_blob.png" to "tile.dirt_connected".
+     * @param path The path to the file.
+     * @return The registry name, or an empty string if the file isn't part of a texture.
+    */
+    static std::string getRegistryNameForFile(const std::filesystem::path &path);
+    /**
+     * @brief Look up the texture ids of an entry, once its textures are loaded.
+    */
+    void setTextureIds(TileData &data) const;
 
     std::unordered_map<std::string, TileData> tiles;
     std::unordered_map<std::string, ObjectData> objects;
@@ -118,6 +299,23 @@ private:
      * @brief The sprite manager.
     */
     ResourceManager resource_manager;
+    /**
+     * @brief The font file, which has to outlive the font since SFML reads it lazily.
+    */
+    VirtualFileSystem::File font_file;
+    /**
+     * @brief The key of the files everything was loaded from, see computeCacheKey().
+     * This is saved in every pack, so the atlas cache can tell if it's out of date.
+     * It's empty if the resources are an archive.
+    */
+    std::string source_key;
+    /**
+     * @brief The files everything was loaded from, see listSourceFiles().
+     * This is saved in every pack too, and is what a pack in the resources
+     * folder is checked against, since it doesn't have to read the files.
+     * It's empty if the resources are an archive.
+    */
+    std::vector<SourceFile> source_files;
     /**
      * @brief The font.
      * TODO: Move this somewhere else?
@@ -158,6 +356,15 @@ private:
      * @return The directory.
     */
     static std::string getDirectory(const std::string &registry_name);
+    /**
+     * @brief Find the images that registering an entry might load.
+     * For entities this is every image in their folder, for everything else
+     * it's the images named after the entry, e.g. "grass.png" and
+     * "grass_connected_blob.png" for "tile.grass".
+     * @param registry_name The registry name.
+     * @return The paths to the images.
+    */
+    static std::vector<std::filesystem::path> findTexturePaths(const std::string &registry_name);
     /**
      * @brief Generate a texture path.
      * @param name The name of the entry to generate a texture path for.
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <filesystem>
+#include <cstdint>
+#include <cstddef>
+
+namespace rpg {
+namespace resources {
+
+/**
+ * @class MappedFile
+ * @brief A read-only file mapped into memory.
+ *
+ * The operating system pages the file in as it's read, so nothing is copied
+ * up front, and the data can be handed straight to e.g. a texture upload.
+*/
+class MappedFile {
+public:
+    /**
+     * @brief Map a file into memory.
+     * @param path The path to the file.
+     * @throws std::runtime_error if the file can't be opened or mapped.
+    */
+    MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    /**
+     * @brief Get the contents of the file.
+    */
+    inline const uint8_t* getData() const { return data; }
+    /**
+     * @brief Get the size of the file in bytes.
+    */
+    inline std::size_t getSize() const { return size; }
+private:
+    const uint8_t *data = nullptr;
+    std::size_t size = 0;
+#ifdef _WIN32
+    void *file_handle = nullptr;
+    void *mapping_handle = nullptr;
+#else
+    int file_descriptor = -1;
+#endif
+    /**
+     * @brief Unmap and close the file (if it's open).
+    */
+    void close();
+};
+
+} // namespace resources
+} // namespace rpg
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+
+namespace rpg {
+namespace resources {
+
+/**
+ * @struct TextureId
+ * @brief The id of a texture in the ResourceManager, see ResourceManager::getTextureId().
+ *
+ * Ids are handed out when a texture is registered and never change, so they can
+ * be looked up once (e.g. in GameRegistry::TileData) and used from then on.
+ * The index is wrapped in its own type so that a texture id can't be passed
+ * where an AnimationClipId (or any other number) is expected.
+*/
+struct TextureId {
+    uint32_t index = INVALID_INDEX;
+    /**
+     * @brief The index of an id that doesn't refer to any texture.
+    */
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+    /**
+     * @brief Check if the id refers to a texture at all.
+    */
+    inline bool isValid() const { return index != INVALID_INDEX; }
+    inline bool operator==(const TextureId &other) const { return index == other.index; }
+    inline bool operator!=(const TextureId &other) const { return index != other.index; }
+    inline bool operator<(const TextureId &other) const { return index < other.index; }
+};
+
+/**
+ * @struct AnimationClipId
+ * @brief The id of an animation clip in the ResourceManager, see ResourceManager::getAnimationId().
+ * Like a TextureId, it never changes once the clip is loaded.
+*/
+struct AnimationClipId {
+    uint32_t index = INVALID_INDEX;
+    /**
+     * @brief The index of an id that doesn't refer to any clip.
+    */
+    static constexpr uint32_t INVALID_INDEX = 0xFFFFFFFF;
+    /**
+     * @brief Check if the id refers to a clip at all.
+    */
+    inline bool isValid() const { return index != INVALID_INDEX; }
+    inline bool operator==(const AnimationClipId &other) const { return index == other.index; }
+    inline bool operator!=(const AnimationClipId &other) const { return index != other.index; }
+    inline bool operator<(const AnimationClipId &other) const { return index < other.index; }
+};
+
+} // namespace resources
+} // namespace rpg
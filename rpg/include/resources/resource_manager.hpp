@@ -3,11 +3,16 @@
 #include <SFML/Graphics.hpp>
 #include <memory>
 #include <filesystem>
+#include <unordered_map>
+#include <map>
 
-#include "resources/animation.hpp"
+#include "resources/resource_ids.hpp"
+#include "resources/animation_clip.hpp"
 #include "resources/weighted_texture.hpp"
 #include "resources/connected_textures/connected_texture.hpp"
 #include "resources/vertex_quad.hpp"
+#include "resources/asset_pack.hpp"
+#include "engine/job_system.hpp"
 
 namespace rpg {
 namespace resources {
@@ -30,6 +35,36 @@ public:
      * @param registry_name The key to assign to the texture, e.g. "tile.grass".
     */
     void loadTexture(const std::filesystem::path &path, const std::string &registry_name = "");
+    /**
+     * @brief Decode a batch of images ahead of time, spread across the job system.
+     * Decoding the pngs and finding their minimum rects is most of the work of
+     * loading a texture, and none of it depends on anything else. The results are
+     * kept until loadTexture() (or a connected texture) asks for the same path,
+     * which then only has to register the rects.
+     * @param paths The paths to the images. Files that don't exist are skipped.
+    */
+    void decodeImages(const std::vector<std::filesystem::path> &paths);
+    /**
+     * @brief Returned instead of an id if a texture isn't loaded.
+    */
+    static constexpr TextureId INVALID_TEXTURE_ID{};
+    /**
+     * @brief Get the id of a texture.
+     * @param registry_name The key of the texture, e.g. "tile.grass".
+     * @return The id, or INVALID_TEXTURE_ID if the texture isn't loaded.
+    */
+    TextureId getTextureId(const std::string &registry_name) const;
+    /**
+     * @brief Get the id of the connected texture of a texture.
+     * @param registry_name The key of the texture, e.g. "tile.grass".
+     * @return The id, or INVALID_TEXTURE_ID if the texture has no connected texture.
+    */
+    TextureId getConnectedTextureId(const std::string &registry_name) const;
+    /**
+     * @brief Get the name of a texture, for error messages and logging.
+     * The names are only kept in debug builds, release builds just print the id.
+    */
+    std::string getTextureName(TextureId id) const;
     /**
      * @brief Get the texture rect of a texture.
      * @param registry_name The key of the texture, e.g. "tile.grass".
@@ -38,10 +73,10 @@ public:
     const sf::IntRect getTextureRect(const std::string &registry_name);
     /**
      * @brief Get the vertex quad of a texture.
-     * @param registry_name The key of the texture, e.g. "tile.grass".
-     * @return The vertex quad.
+     * @param id The id of the texture, see getTextureId().
+     * @return The vertex quad, or the default vertex quad if the id is invalid.
     */
-    const VertexQuad& getVertexQuad(const std::string &registry_name);
+    inline const VertexQuad& getVertexQuad(TextureId id) const { return id.index < vertex_quads.size() ? vertex_quads[id.index] : default_vertex_quad; }
     /**
      * @brief Check if an animation exists.
      * @param registry_name The key of the animation, e.g. "entity.player_walk_down".
@@ -49,47 +84,86 @@ public:
     */
     bool hasAnimation(const std::string &registry_name);
     /**
-     * @brief Get a specific animation.
+     * @brief Get the id of an animation.
      * @param registry_name The key of the animation, e.g. "entity.player_walk_down".
-     * @return The animation.
+     * @return The id of the animation clip.
+    */
+    AnimationClipId getAnimationId(const std::string &registry_name);
+    /**
+     * @brief Get a specific animation by id.
+     * This doesn't check the id, see getAnimationId().
+     * @param id The id of the animation clip.
+     * @return The animation clip.
     */
-    Animation& getAnimation(const std::string &registry_name);
+    inline const AnimationClip& getAnimation(AnimationClipId id) const { return animation_clips[id.index]; }
     /**
      * @brief Check if a texture has variations.
-     * @param registry_name The key of the texture, e.g. "tile.grass".
+     * @param id The id of the texture, see getTextureId().
      * @return True if the texture has variations, false otherwise.
     */
-    bool hasVariations(const std::string &registry_name);
+    inline bool hasVariations(TextureId id) const { return id.index < variations.size() && variations[id.index] != nullptr; }
     /**
      * @brief Get a collection of variations of a texture.
-     * @param registry_name The key of the texture, e.g. "tile.grass".
-     * @return The texture collection.
+     * @param id The id of the texture, see getTextureId().
+     * @return The texture collection, or nullptr if the texture has no variations
+     * (or the id is out of range).
     */
-    std::shared_ptr<WeightedTexture> getVariations(const std::string &registry_name);
+    inline const std::shared_ptr<WeightedTexture>& getVariations(TextureId id) const { return id.index < variations.size() ? variations[id.index] : no_variations; }
     /**
-     * @brief Check if a texture has connected textures.
-     * @param registry_name The key of the texture, e.g. "tile.grass".
-     * @return True if the texture has connected textures, false otherwise.
+     * @brief Check if a connected texture exists.
+     * @param id The id of the connected texture, see getConnectedTextureId().
+     * @return True if the connected texture exists, false otherwise.
     */
-    bool hasConnectedTexture(const std::string &registry_name);
+    inline bool hasConnectedTexture(TextureId id) const { return id.index < connected_textures.size() && connected_textures[id.index] != nullptr; }
     /**
      * @brief Get a connected texture.
-     * @param registry_name The key of the texture, e.g. "tile.grass".
-     * @return The connected texture.
+     * @param id The id of the connected texture, see getConnectedTextureId().
+     * @return The connected texture, or nullptr if there isn't one (or the id
+     * is out of range).
     */
-    std::shared_ptr<connected_textures::ConnectedTexture> getConnectedTexture(const std::string &registry_name);
+    inline const std::shared_ptr<connected_textures::ConnectedTexture>& getConnectedTexture(TextureId id) const { return id.index < connected_textures.size() ? connected_textures[id.index] : no_connected_texture; }
     /**
      * @brief Build the texture atlas.
      * This is used to store all of the textures.
      * This should only be called once after all of the textures have been loaded.
+     * The textures are packed into as few pages as possible, each of which can
+     * be as large as the GPU allows. Whatever doesn't fit on a page spills onto
+     * the next one, and the page of each texture is stored in its vertex quad
+     * (and its animation, connected texture, etc.).
+     * The images of each page are composed first, and then uploaded to the GPU
+     * in one go. The images are freed afterwards.
      * TODO: Maybe this should be called automatically when the first texture is loaded?
+     * @throws std::runtime_error if a texture is too large for a page.
     */
     void buildTextureAtlas();
     /**
-     * @brief Get the texture atlas.
-     * @return The texture atlas.
+     * @brief Get a page of the texture atlas.
+     * @param page The index of the page, see VertexQuad::getPage().
+     * @return The texture of the page.
+    */
+    const inline sf::Texture& getTextureAtlas(uint32_t page = 0) const { return texture_atlas_pages[page]; }
+    /**
+     * @brief Get the number of pages in the texture atlas.
+    */
+    inline std::size_t getTextureAtlasPageCount() const { return texture_atlas_pages.size(); }
+
+    /**
+     * @brief Get the minimum rect for an image.
+     * This is used to crop the image to remove any transparent pixels.
+     * The size of the rect is the size of the image in the texture atlas.
+     * A fully transparent image isn't trimmed at all.
+     * @param image The image.
+     * @return The minimum rect.
+    */
+    static const sf::IntRect getMinimumRect(const sf::Image &image);
+    /**
+     * @brief Crop an image.
+     * This crops the image to the specified rect.
+     * @param image The image.
+     * @param rect The rect to crop the image to.
+     * @return The cropped image.
     */
-    const inline sf::Texture& getTextureAtlas() const { return texture_atlas; }
+    static const sf::Image cropImage(const sf::Image &image, const sf::IntRect &rect);
 
     // Singleton stuff
     ResourceManager(ResourceManager const&) = delete;
@@ -98,78 +172,280 @@ private:
     /**
      * @brief Construct a new ResourceManager object.
      * This is private because this is a singleton class.
+     * Nothing is loaded until either loadDefaultTexture() or loadPack() is called.
+    */
+    ResourceManager() = default;
+    /**
+     * @brief Load the texture that is used when a texture is missing.
+     * This has to be done before loading any other textures from files.
+    */
+    void loadDefaultTexture();
+    /**
+     * @brief Write the texture atlas and the rects of everything in it to an asset pack.
+     * The texture atlas must have been built already.
+     * @throws std::runtime_error if the texture atlas is being repacked.
+    */
+    void savePack(AssetPackWriter &writer) const;
+    /**
+     * @brief Load the texture atlas and the rects of everything in it from an asset pack.
+     * This replaces loading the textures and building the texture atlas.
+    */
+    void loadPack(AssetPackReader &reader);
+    /**
+     * @brief The types of connected textures, as stored in an asset pack.
     */
-    ResourceManager();
+    enum class ConnectedTextureType : uint8_t {
+        FENCE,
+        BLOB
+    };
     /**
-     * @brief A map of registry names to textures.
+     * @brief A map of registry names to texture ids.
+     * This is only needed to look up the ids, everything else is indexed by id.
     */
-    std::map<std::string, sf::Texture> textures;
+    std::unordered_map<std::string, TextureId> texture_ids;
+#ifndef NDEBUG
+    /**
+     * @brief The registry name of each texture, indexed by id, see getTextureName().
+    */
+    std::vector<std::string> texture_names;
+#endif
+    /**
+     * @brief Get the id of a texture, and register the texture if it's new.
+     * @param registry_name The key of the texture, e.g. "tile.grass".
+     * @return The id of the texture.
+    */
+    TextureId registerTexture(const std::string &registry_name);
+    /**
+     * @brief The images of the textures, indexed by id.
+     * These only live on the CPU until buildTextureAtlas() uploads them.
+    */
+    std::vector<sf::Image> images;
     /**
      * @brief The default texture.
      * This is returned if a texture isn't found.
     */
-    sf::Texture default_texture;
+    sf::Image default_image;
+    /**
+     * @brief An image decoded by decodeImages(), waiting to be loaded.
+    */
+    struct DecodedImage {
+        sf::Image image;
+        sf::IntRect minimum_rect;
+    };
+    /**
+     * @brief The images decoded by decodeImages(), by their (normalised) path.
+    */
+    std::unordered_map<std::string, DecodedImage> decoded_images;
     /**
-     * @brief A map of registry names to vertex quads.
+     * @brief The vertex quads of the textures, indexed by id.
     */
-    std::map<std::string, VertexQuad> vertex_quads;
+    std::vector<VertexQuad> vertex_quads;
     /**
      * @brief The default vertex quad.
      * This is returned if the quad isn't found.
     */
     VertexQuad default_vertex_quad;
     /**
-     * @brief A map of registry names to animations.
+     * @brief The animation clips, indexed by their id.
     */
-    std::map<std::string, Animation> animations;
+    std::vector<AnimationClip> animation_clips;
+    /**
+     * @brief The animation clip of each texture, indexed by texture id.
+     * AnimationClip::INVALID_ID if the texture isn't animated.
+    */
+    std::vector<AnimationClipId> animations;
     /**
      * @brief The suffix for animation files.
     */
     static constexpr const char* ANIMATION_EXTENSION = ".animation.json";
     /**
-     * @brief A map of registry names to texture collections.
+     * @brief The texture collection of each texture, indexed by texture id.
      * This is used for variations of the same texture, e.g. a grass tile with
-     * different variations of grass.
+     * different variations of grass. nullptr if the texture has no variations.
     */
-    std::map<std::string, std::shared_ptr<WeightedTexture>> variations;
+    std::vector<std::shared_ptr<WeightedTexture>> variations;
     /**
      * @brief The suffix for variation files.
     */
     static constexpr const char* VARIATIONS_EXTENSION = ".variations.json";
     /**
-     * @brief A map of registry names to connected textures.
+     * @brief Returned by getVariations() for ids out of range.
+    */
+    std::shared_ptr<WeightedTexture> no_variations;
+    /**
+     * @brief The connected texture of each texture, indexed by texture id.
      * This is used for connected textures, e.g. a dirt tile next to a grass tile.
+     * They are stored at the id of their own texture (registry_name + "_connected"),
+     * and nullptr for every other texture.
     */
-    std::map<std::string, std::shared_ptr<connected_textures::ConnectedTexture>> connected_textures;
+    std::vector<std::shared_ptr<connected_textures::ConnectedTexture>> connected_textures;
     /**
      * @brief The suffix for connected texture files.
     */
     static constexpr const char* CONNECTED_TEXTURE_BLOB_EXTENSION = "_connected_blob.png";
     static constexpr const char* CONNECTED_TEXTURE_FENCE_EXTENSION = "_connected_fence.png";
     /**
-     * @brief The texture atlas.
-     * This is used to store all of the textures.
+     * @brief Returned by getConnectedTexture() for ids out of range.
     */
-    sf::Texture texture_atlas;
+    std::shared_ptr<connected_textures::ConnectedTexture> no_connected_texture;
+    /**
+     * @brief The pages of the texture atlas.
+     * This is used to store all of the textures.
+     * Replaced as a whole when the atlas is repacked, see pollRepack().
+    */
+    std::vector<sf::Texture> texture_atlas_pages;
+    /**
+     * @brief The pixels of each page of the texture atlas, as they were uploaded.
+     * Kept so the atlas can be saved (or repacked) without reading it back from the GPU.
+     * Empty while a repack is running, since the repack job has them, see Repack::source_pages.
+    */
+    std::vector<sf::Image> atlas_images;
+    /**
+     * @brief Pack rectangles into as few pages as possible.
+     * Whatever doesn't fit on a page spills onto the next one. This doesn't
+     * touch the GPU, so it can run on a job.
+     * @param sizes The sizes of the rectangles.
+     * @param rects Receives the position of each rectangle on its page.
+     * @param pages Receives the page of each rectangle.
+     * @param page_sizes Receives the size of each page.
+     * @param too_large Receives the index of a rectangle that doesn't fit on an empty page.
+     * @param max_side The largest a page can be, see sf::Texture::getMaximumSize().
+     * @return False if a rectangle doesn't fit on an empty page.
+    */
+    static bool packRects(const std::vector<sf::Vector2i> &sizes, std::vector<sf::IntRect> &rects, std::vector<uint32_t> &pages,
+        std::vector<sf::Vector2i> &page_sizes, std::size_t &too_large, int max_side);
+    /**
+     * @brief Move a texture (and its animation, variations and connected texture) to a rect in the atlas.
+     * @param id The id of the texture.
+     * @param rect The rect of the texture in the atlas.
+     * @param page The page the rect is on.
+    */
+    void placeTexture(TextureId id, const sf::IntRect &rect, uint32_t page);
+    /**
+     * @brief A repack of the texture atlas, see startRepack().
+     * The job only reads and writes this, never the resource manager itself.
+    */
+    struct Repack {
+        engine::JobCounter counter;
+        /**
+         * @brief The pages of the atlas when the repack was started, moved out
+         * of atlas_images and moved back once the repack is done.
+        */
+        std::vector<sf::Image> source_pages;
+        /**
+         * @brief The rect and page of each texture in source_pages, indexed by id.
+        */
+        std::vector<sf::IntRect> source_rects;
+        std::vector<uint32_t> source_page_ids;
+        /**
+         * @brief The new (cropped) images of the textures that changed.
+        */
+        std::map<TextureId, sf::Image> changed;
+        /**
+         * @brief The repacked pages, and the new rect and page of each texture.
+        */
+        std::vector<sf::Image> pages;
+        std::vector<sf::IntRect> rects;
+        std::vector<uint32_t> page_ids;
+        /**
+         * @brief Set if a texture doesn't fit on an empty page.
+        */
+        bool failed = false;
+        std::size_t too_large = 0;
+    };
+    /**
+     * @brief The repack that is running, or nullptr.
+    */
+    std::unique_ptr<Repack> repack;
+    /**
+     * @brief Reloaded images that didn't fit in their rect, waiting for the next repack.
+    */
+    std::map<TextureId, sf::Image> pending_images;
+    /**
+     * @brief A changed image being decoded on a job, see reloadTexture().
+     * The job only reads and writes this, never the resource manager itself.
+    */
+    struct TextureReload {
+        engine::JobCounter counter;
+        std::filesystem::path path;
+        std::string registry_name;
+        TextureId id;
+        /**
+         * @brief Whether or not the image is cropped to its minimum rect, like loadTexture() does it.
+        */
+        bool crop = false;
+        /**
+         * @brief The decoded (and cropped) image, if it could be decoded.
+        */
+        sf::Image image;
+        bool loaded = false;
+    };
+    /**
+     * @brief The reloads that are running, in the order they were started.
+    */
+    std::vector<std::unique_ptr<TextureReload>> texture_reloads;
+    /**
+     * @brief Patch the reloaded textures whose images are decoded into the atlas.
+     * Textures that no longer fit in their rect are handed to the next repack.
+    */
+    void pollTextureReloads();
+    /**
+     * @brief Patch a single decoded image into the atlas, see pollTextureReloads().
+    */
+    void applyTextureReload(TextureReload &reload);
+    /**
+     * @brief Start repacking the atlas with the pending images on a job.
+     * Does nothing if a repack is already running, or nothing is pending.
+    */
+    void startRepack();
+    /**
+     * @brief Swap in the repacked atlas once the repack job is done.
+     * The new pages are uploaded first, and then every texture, animation,
+     * variation and connected texture is moved to its new rect at once.
+     * Anything that copied a rect or a clip out of the resource manager has
+     * to copy it again.
+     * @return True if the atlas was swapped.
+    */
+    bool pollRepack();
     /**
      * @brief Set the texture for a registry name.
      * The texture is NOT added to the texture atlas here, it is only added to
-     * the map of textures. The texture atlas is built when buildTextureAtlas() is called.
+     * the map of images. The texture atlas is built when buildTextureAtlas() is called.
      * @param registry_name The key of the texture, e.g. "tile.grass".
-     * @param texture The texture.
+     * @param image The image of the texture.
      * @param texture_rect The texture rect. 
      * The position of the rect must be relative to the given texture. Once the texture
      * atlas is built, the position of the rect will be moved to the position of the
      * texture in the texture atlas. The size of the rect will remain the same.
     */
-    void setTexture(const std::string &registry_name, const sf::Texture &texture, const sf::IntRect &texture_rect);
+    void setTexture(const std::string &registry_name, const sf::Image &image, const sf::IntRect &texture_rect);
     /**
-     * @brief Get a texture by its key, e.g. "tile.grass".
+     * @brief Set the texture rect (and the scale) of the vertex quad for a registry name.
+     * @param registry_name The key of the texture, e.g. "tile.grass".
+     * @param texture_rect The texture rect.
+     * @param page The page of the texture atlas the rect is on.
+     * @return The id of the texture.
+    */
+    TextureId setVertexQuad(const std::string &registry_name, const sf::IntRect &texture_rect, uint32_t page = 0);
+    /**
+     * @brief Get the image of a texture by its key, e.g. "tile.grass".
      * If the texture isn't already loaded, the default texture is returned.
+     * This is only valid until the texture atlas is built.
      * @param registry_name The key of the texture.
-     * @return The texture.
+     * @return The image.
     */
-    const sf::Texture& getTexture(const std::string &registry_name);
+    const sf::Image& getImage(const std::string &registry_name);
+    /**
+     * @brief Get an image from decodeImages(), or decode it now if it wasn't decoded ahead of time.
+     * @param path The path to the image.
+     * @param decoded_image Receives the image and its minimum rect.
+     * @return True if the image could be decoded, false otherwise.
+    */
+    bool takeDecodedImage(const std::filesystem::path &path, DecodedImage &decoded_image);
+    /**
+     * @brief Get the key of a path in the map of decoded images.
+    */
+    static std::string getImageKey(const std::filesystem::path &path);
     /**
      * @brief Load the extra files associated with a texture.
      * This loads animations, variations, connected textures, etc.
@@ -180,37 +456,50 @@ private:
     */
     bool loadExtraFiles(const std::filesystem::path &path, const std::string &registry_name);
     /**
-     * @brief Get the minimum rect for an image.
-     * This is used to crop the image to remove any transparent pixels.
-     * The size of the rect is the size of the image in the texture atlas.
-     * @param image The image.
-     * @return The minimum rect.
+     * @brief Check if a texture has any extra files, see loadExtraFiles().
+     * Textures with extra files aren't cropped.
     */
-    const sf::IntRect getMinimumRect(const sf::Image &image);
+    bool hasExtraFiles(const std::filesystem::path &path);
     /**
-     * @brief Crop an image.
-     * This crops the image to the specified rect.
-     * @param image The image.
-     * @param rect The rect to crop the image to.
-     * @return The cropped image.
+     * @brief Replace the pixels of a texture after the texture atlas was built.
+     * The image is decoded on a job, and patched in by pollTextureReloads().
+     * If the new image still fits in the rect of the texture, it's written over
+     * the old one in the atlas, and everything drawn with the rect picks it up
+     * straight away. Otherwise the atlas is repacked on a job, and swapped in
+     * by pollRepack() once it's done.
+     * @param path The path to the changed image.
+     * @param registry_name The key of the texture, e.g. "tile.grass".
+    */
+    void reloadTexture(const std::filesystem::path &path, const std::string &registry_name);
+    /**
+     * @brief Reload the frame rate of an animation, keeping its id and frames.
+     * Anything that copied the clip has to refresh it, see ecs::AnimationBatch::refreshClip().
+     * @param path The path to the animation file.
+     * @param registry_name The key of the animation, e.g. "entity.player_idle_down".
+    */
+    void reloadAnimation(const std::filesystem::path &path, const std::string &registry_name);
+    /**
+     * @brief Reload the weights of a texture's variations in place.
+     * @param path The path to the variation file.
+     * @param registry_name The key of the texture, e.g. "tile.grass".
     */
-    const sf::Image cropImage(const sf::Image &image, const sf::IntRect &rect);
+    void reloadVariations(const std::filesystem::path &path, const std::string &registry_name);
     /**
      * @brief Extract the rects (subimages) from a texture.
      * This is used for animations and variations.
-     * @param texture The texture.
+     * @param image The image of the texture.
      * @return The rects.
     */
-    std::vector<sf::IntRect> getRects(const sf::Texture &texture);
+    std::vector<sf::IntRect> getRects(const sf::Image &image);
     /**
      * @brief Split a texture into frames.
      * This is used for animations and variations.
-     * @param source_texture The source texture.
+     * @param source_image The image of the source texture.
      * @param frame_width The width of each frame.
      * @param frame_height The height of each frame.
      * @return The frames.
     */
-    std::vector<sf::Image> splitTexture(const sf::Texture& source_texture, int frame_width, int frame_height);
+    std::vector<sf::Image> splitTexture(const sf::Image& source_image, int frame_width, int frame_height);
     /**
      * @brief Load the animation for a texture.
      * @param path The path to the animation file.
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <SFML/Graphics.hpp>
+#include <array>
+#include <cstdint>
 
 namespace rpg {
 namespace resources {
@@ -12,9 +14,14 @@ namespace resources {
  * This provides a middle ground between a sf::VertexArray and a sf::Sprite.
  * More specifically, it provides the performance of a sf::VertexArray with the
  * convenience of a sf::Sprite.
+ * The vertices are stored inline, so a quad never allocates.
 */
 class VertexQuad {
 public:
+    /**
+     * @brief The four vertices of a quad.
+    */
+    using Vertices = std::array<sf::Vertex, 4>;
     /**
      * @brief Construct a new VertexQuad object.
      * @param position The position of the quad.
@@ -63,10 +70,19 @@ public:
      * @brief Get the texture rect of the quad.
     */
     sf::IntRect getTextureRect() const;
+    /**
+     * @brief Set the page of the texture atlas the texture rect is on.
+    */
+    inline void setPage(uint32_t page) { this->page = page; }
+    /**
+     * @brief Get the page of the texture atlas the texture rect is on.
+     * The quad has to be drawn with that page, see ResourceManager::getTextureAtlas().
+    */
+    inline uint32_t getPage() const { return page; }
     /**
      * @brief Get the vertices of the quad.
     */
-    inline const std::vector<sf::Vertex>& getVertices() const { return vertices; };
+    inline const Vertices& getVertices() const { return vertices; };
     /**
      * @brief Flip the texture coordinates of the quad.
      * @param flip_x Whether to flip the texture coordinates on the x axis.
@@ -74,8 +90,9 @@ public:
     */
     void flipTexture(bool flip_x, bool flip_y);
 private:
-    std::vector<sf::Vertex> vertices;
+    Vertices vertices;
     float scale;
+    uint32_t page = 0;
 };
 
 } // namespace resources
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <filesystem>
+#include <unordered_map>
+#include <memory>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+#include "resources/mapped_file.hpp"
+
+namespace rpg {
+namespace resources {
+
+/**
+ * @class VirtualFileSystem
+ * @brief Finds and reads the files in the resources, wherever they are stored.
+ *
+ * The root is either a folder, or an archive that holds the whole folder in
+ * a single file (see writeArchive()). Either way the files are addressed by
+ * their path under the root, e.g. "<root>/tile/grass.png", so the rest of the
+ * game doesn't have to know which one it is.
+ *
+ * Every file under the root is indexed when it's mounted, so checking if a
+ * file exists or listing a folder is a lookup in a hash map rather than a
+ * call to the operating system. Files are mapped into memory rather than
+ * read, and the files in an archive are never copied at all.
+ *
+ * An archive is written with an AssetPackWriter (see asset_pack.hpp), with
+ * its own magic. After the header comes the number of files, then the path
+ * (relative to the root), offset and size of each file, and then the contents
+ * of the files. Each file starts on a multiple of ARCHIVE_ALIGNMENT, and the
+ * offsets are relative to the first one.
+*/
+class VirtualFileSystem {
+public:
+    /**
+     * @brief Identifies a file as an archive.
+    */
+    static constexpr uint32_t ARCHIVE_MAGIC = 0x41475052; // "RPGA"
+    /**
+     * @brief Must be increased whenever the layout of the archive changes.
+    */
+    static constexpr uint32_t ARCHIVE_VERSION = 1;
+    /**
+     * @brief The alignment of each file in an archive.
+    */
+    static constexpr std::size_t ARCHIVE_ALIGNMENT = 16;
+    /**
+     * @brief The contents of a file, mapped into memory.
+     * The data stays valid for as long as any copy of the file is kept.
+    */
+    struct File {
+        std::shared_ptr<const MappedFile> mapping;
+        const uint8_t *data = nullptr;
+        std::size_t size = 0;
+        inline const uint8_t* begin() const { return data; }
+        inline const uint8_t* end() const { return data + size; }
+    };
+    /**
+     * @brief Get the VirtualFileSystem instance.
+    */
+    static VirtualFileSystem& getInstance() {
+        static VirtualFileSystem instance;
+        return instance;
+    }
+    VirtualFileSystem(VirtualFileSystem const&) = delete;
+    void operator=(VirtualFileSystem const&) = delete;
+    /**
+     * @brief Mount a folder or an archive as the root, and index its files.
+     * This replaces whatever was mounted before.
+     * @param root The path to the folder or the archive.
+     * @throws std::runtime_error if the root doesn't exist, or isn't a valid archive.
+    */
+    void mount(const std::filesystem::path &root);
+    /**
+     * @brief Get the path that was mounted.
+    */
+    inline const std::filesystem::path& getRoot() const { return root; }
+    /**
+     * @brief Check if the root is an archive rather than a folder.
+    */
+    inline bool isArchive() const { return archive != nullptr; }
+    /**
+     * @brief Check if a file exists.
+     * @param path The path to the file, under the root.
+    */
+    bool exists(const std::filesystem::path &path) const;
+    /**
+     * @brief Check if a folder has any files in it.
+     * @param path The path to the folder, under the root.
+    */
+    bool isDirectory(const std::filesystem::path &path) const;
+    /**
+     * @brief Get the files in a folder, not counting the ones in its subfolders.
+     * @param path The path to the folder, under the root.
+     * @return The paths to the files (under the root), sorted by name.
+    */
+    std::vector<std::filesystem::path> list(const std::filesystem::path &path) const;
+    /**
+     * @brief Open a file.
+     * @param path The path to the file, under the root.
+     * @return The contents of the file.
+     * @throws std::runtime_error if the file doesn't exist, or can't be mapped.
+    */
+    File open(const std::filesystem::path &path) const;
+    /**
+     * @brief Open a file on disk that isn't part of the file system, e.g. the atlas cache.
+     * @param path The path to the file.
+     * @throws std::runtime_error if the file can't be mapped.
+    */
+    static File map(const std::filesystem::path &path);
+    /**
+     * @brief Write every file in a folder to an archive, which can then be mounted instead.
+     * Hidden folders (e.g. the atlas cache) and the archive itself are left out.
+     * @param folder The folder.
+     * @param archive_path The path to write the archive to.
+     * @throws std::runtime_error if a file can't be read, or the archive can't be written.
+    */
+    static void writeArchive(const std::filesystem::path &folder, const std::filesystem::path &archive_path);
+private:
+    VirtualFileSystem() = default;
+    /**
+     * @brief Where a file is stored.
+     * For a folder only the path is needed, for an archive the offset is from
+     * the start of the archive.
+    */
+    struct Entry {
+        std::size_t offset = 0;
+        std::size_t size = 0;
+    };
+    /**
+     * @brief Get the key of a path in the index, i.e. the path relative to the root.
+     * @param path The path, under the root.
+     * @param key Receives the key, which is empty for the root itself.
+     * @return False if the path isn't under the root.
+    */
+    bool getKey(const std::filesystem::path &path, std::string &key) const;
+    /**
+     * @brief Index the files in the mounted folder.
+    */
+    void indexFolder();
+    /**
+     * @brief Index the files in the mounted archive.
+    */
+    void indexArchive();
+    /**
+     * @brief Add a file to the index of its folder, see list().
+    */
+    void addToFolder(const std::string &key);
+    std::filesystem::path root;
+    /**
+     * @brief The archive, if the root is one.
+    */
+    std::shared_ptr<const MappedFile> archive;
+    /**
+     * @brief Every file under the root, by key.
+    */
+    std::unordered_map<std::string, Entry> entries;
+    /**
+     * @brief The keys of the files in each folder, by the key of the folder.
+    */
+    std::unordered_map<std::string, std::vector<std::string>> folders;
+};
+
+} // namespace resources
+} // namespace rpg
@@ -33,6 +33,11 @@ public:
      * @return A random rect from the collection.
     */
     sf::IntRect getRandomRect() const;
+    /**
+     * @brief Get the index of a random rect from the collection, see getRect().
+     * @return A random index, picked by the weights.
+    */
+    int getRandomIndex() const;
     /**
      * @brief Get a rect from the collection.
      * @param index The index of the rect in the collection.
@@ -2,6 +2,9 @@
 #include "resources/game_registry.hpp"
 
 #include <cstdio>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 namespace rpg {
 namespace engine {
@@ -47,6 +50,60 @@ void AABB::resolveCollision(const AABB &other, sf::Vector2f &penetrationDepth, s
     }
 }
 
+float AABB::sweep(const AABB &other, const sf::Vector2f &offset, sf::Vector2f &collision_normal) const {
+    collision_normal = sf::Vector2f(0.f, 0.f);
+    if (offset.x == 0.f && offset.y == 0.f) {
+        // Not moving at all, so there's nothing to run into
+        return 1.f;
+    }
+    const float infinity = std::numeric_limits<float>::infinity();
+    // Find the times at which the AABBs start and stop overlapping along each axis
+    float entry_x, exit_x, entry_y, exit_y;
+    if (offset.x > 0.f) {
+        entry_x = (other.left - (left + width)) / offset.x;
+        exit_x = (other.left + other.width - left) / offset.x;
+    } else if (offset.x < 0.f) {
+        entry_x = (other.left + other.width - left) / offset.x;
+        exit_x = (other.left - (left + width)) / offset.x;
+    } else {
+        // Not moving along this axis, so we either always or never overlap
+        if (left + width <= other.left || left >= other.left + other.width) {
+            return 1.f;
+        }
+        entry_x = -infinity;
+        exit_x = infinity;
+    }
+    if (offset.y > 0.f) {
+        entry_y = (other.top - (top + height)) / offset.y;
+        exit_y = (other.top + other.height - top) / offset.y;
+    } else if (offset.y < 0.f) {
+        entry_y = (other.top + other.height - top) / offset.y;
+        exit_y = (other.top - (top + height)) / offset.y;
+    } else {
+        if (top + height <= other.top || top >= other.top + other.height) {
+            return 1.f;
+        }
+        entry_y = -infinity;
+        exit_y = infinity;
+    }
+    // The AABBs only overlap once they overlap along both axes
+    float entry = std::max(entry_x, entry_y);
+    float exit = std::min(exit_x, exit_y);
+    // Convert the epsilon from a distance to a time along the offset
+    float epsilon = SWEEP_EPSILON / std::max(std::abs(offset.x), std::abs(offset.y));
+    if (entry > exit || entry >= 1.f || entry < -epsilon) {
+        // Either we miss, we don't get there this time, or we're already overlapping
+        return 1.f;
+    }
+    // The axis we entered on last is the one we hit
+    if (entry_x > entry_y) {
+        collision_normal.x = (offset.x > 0.f) ? -1.f : 1.f;
+    } else {
+        collision_normal.y = (offset.y > 0.f) ? -1.f : 1.f;
+    }
+    return std::max(entry, 0.f);
+}
+
 void AABB::draw(sf::RenderTarget &target, sf::RenderStates states) const {
     // Draw the AABB as a rectangle.
     sf::Vector2f position = getPosition();
@@ -0,0 +1,47 @@
+#include "engine/animation_table.hpp"
+#include "engine/entity.hpp"
+
+namespace rpg {
+namespace engine {
+
+AnimationTable::AnimationTable(const resources::GameRegistry::EntityData &data) {
+    setAnimations(data.animations, data.registry_name, IDLE, Entity::IDLE_DOWN, Entity::IDLE_UP, Entity::IDLE_LEFT_RIGHT);
+    setAnimations(data.animations, data.registry_name, WALK, Entity::WALK_DOWN, Entity::WALK_UP, Entity::WALK_LEFT_RIGHT);
+    setAnimations(data.animations, data.registry_name, ATTACK, Entity::ATTACK_DOWN, Entity::ATTACK_UP, Entity::ATTACK_LEFT_RIGHT);
+}
+
+const AnimationTable::Slot& AnimationTable::getMovement(const sf::Vector2f &direction, const sf::Vector2f &previous_direction) const {
+    if (direction.x != 0 || direction.y != 0) {
+        return slots[WALK][getFacing(direction)];
+    }
+    return slots[IDLE][getFacing(previous_direction)];
+}
+
+AnimationTable::Facing AnimationTable::getFacing(const sf::Vector2f &direction) {
+    if (direction.y > 0) {
+        return DOWN;
+    } else if (direction.y < 0) {
+        return UP;
+    } else if (direction.x < 0) {
+        return LEFT;
+    } else if (direction.x > 0) {
+        return RIGHT;
+    }
+    return DOWN;
+}
+
+void AnimationTable::setAnimations(const std::map<std::string, resources::AnimationClipId> &animations, const std::string &registry_name,
+    State state, const char *down, const char *up, const char *left_right) {
+    auto find = [&](const char *key) {
+        auto it = animations.find(registry_name + "_" + key);
+        return it != animations.end() ? it->second : resources::AnimationClip::INVALID_ID;
+    };
+    std::array<Slot, FACING_COUNT> &state_slots = slots[state];
+    state_slots[DOWN] = {find(down), false};
+    state_slots[UP] = {find(up), false};
+    state_slots[LEFT] = {find(left_right), true};
+    state_slots[RIGHT] = {find(left_right), false};
+}
+
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,51 @@
+#include "engine/chunk.hpp"
+
+#include <algorithm>
+
+namespace rpg {
+namespace engine {
+
+Chunk::Chunk(const sf::Vector2i &position) : position(position) {}
+
+GameObject& Chunk::createStaticObject(const sf::Vector2f &position, const resources::GameRegistry::ObjectData &data) {
+    GameObject *object = static_object_pool.get(static_object_pool.create(position, data));
+    static_objects.push_back(object);
+    baked = false;
+    return *object;
+}
+
+void Chunk::clearStaticObjects() {
+    static_objects.clear();
+    static_object_pool.clear();
+    baked = false;
+}
+
+void Chunk::refreshTextures() {
+    for (GameObject *object : static_objects) {
+        object->refreshTexture();
+    }
+    baked = false;
+}
+
+void Chunk::bake() {
+    // Same order as the objects are drawn in, see World::update
+    std::stable_sort(static_objects.begin(), static_objects.end(), [](const GameObject *a, const GameObject *b) {
+        return a->getAABB().top < b->getAABB().top;
+    });
+    static_aabbs.clear();
+    static_aabbs.reserve(static_objects.size());
+    static_vertices.clear();
+    static_vertices.reserve(static_objects.size() * 4);
+    static_pages.clear();
+    static_pages.reserve(static_objects.size());
+    for (const GameObject *object : static_objects) {
+        static_aabbs.push_back(object->getAABB());
+        static_pages.push_back(object->getPage());
+        const resources::VertexQuad::Vertices &vertices = object->getVertices();
+        static_vertices.insert(static_vertices.end(), vertices.begin(), vertices.end());
+    }
+    baked = true;
+}
+
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,275 @@
+#include "engine/chunk_map.hpp"
+#include "engine/constants.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace rpg {
+namespace engine {
+
+ChunkMap::ChunkMap(const sf::Vector2i &dimensions) : dimensions(dimensions) {
+    // Round up so that the chunks cover the whole world
+    chunk_dimensions.x = (dimensions.x + constants::CHUNK_SIZE - 1) / constants::CHUNK_SIZE;
+    chunk_dimensions.y = (dimensions.y + constants::CHUNK_SIZE - 1) / constants::CHUNK_SIZE;
+    chunks.reserve(chunk_dimensions.x * chunk_dimensions.y);
+    for (int y = 0; y < chunk_dimensions.y; y++) {
+        for (int x = 0; x < chunk_dimensions.x; x++) {
+            chunks.emplace_back(sf::Vector2i(x, y));
+        }
+    }
+}
+
+bool ChunkMap::isSolid(int x, int y) const {
+    const Chunk* chunk = getChunk(x, y);
+    if (chunk == nullptr) {
+        return true;
+    }
+    return chunk->isSolid(x % constants::CHUNK_SIZE, y % constants::CHUNK_SIZE);
+}
+
+void ChunkMap::setSolid(int x, int y, bool is_solid) {
+    Chunk* chunk = getChunk(x, y);
+    if (chunk == nullptr) {
+        return;
+    }
+    chunk->setSolid(x % constants::CHUNK_SIZE, y % constants::CHUNK_SIZE, is_solid);
+}
+
+sf::Vector2f ChunkMap::sweep(const AABB &aabb, const sf::Vector2f &offset) const {
+    sf::Vector2f result(0.0f, 0.0f);
+    result.x = sweepX(aabb, offset.x);
+    // The y sweep starts from wherever the x sweep ended
+    AABB moved = aabb;
+    moved.move(sf::Vector2f(result.x, 0.0f));
+    result.y = sweepY(moved, offset.y);
+    return result;
+}
+
+const Chunk* ChunkMap::getChunk(int x, int y) const {
+    if (x < 0 || x >= dimensions.x || y < 0 || y >= dimensions.y) {
+        return nullptr;
+    }
+    return &chunks[x / constants::CHUNK_SIZE + (y / constants::CHUNK_SIZE) * chunk_dimensions.x];
+}
+
+Chunk* ChunkMap::getChunk(int x, int y) {
+    return const_cast<Chunk*>(static_cast<const ChunkMap*>(this)->getChunk(x, y));
+}
+
+GameObject& ChunkMap::createStaticObject(const sf::Vector2f &position, const resources::GameRegistry::ObjectData &data) {
+    // Same as the AABB of the object, which isn't constructed until we know it fits
+    AABB aabb(position + data.footprint.getPosition(), data.footprint.getSize());
+    if (aabb.width > constants::CHUNK_SIZE || aabb.height > constants::CHUNK_SIZE) {
+        throw std::runtime_error("ChunkMap::" + std::string(__func__) + "(): Static objects can't be larger than a chunk");
+    }
+    int x = (int) std::floor(aabb.left);
+    int y = (int) std::floor(aabb.top);
+    Chunk* chunk = getChunk(x, y);
+    if (chunk == nullptr) {
+        throw std::runtime_error("ChunkMap::" + std::string(__func__) + "(): Static object at (" +
+            std::to_string(x) + ", " + std::to_string(y) + ") is outside the world");
+    }
+    if (chunk->isBaked()) {
+        unbaked_chunks.push_back(chunk - chunks.data());
+    }
+    return chunk->createStaticObject(position, data);
+}
+
+void ChunkMap::clearStaticObjects(int chunk_x, int chunk_y) {
+    if (chunk_x < 0 || chunk_x >= chunk_dimensions.x || chunk_y < 0 || chunk_y >= chunk_dimensions.y) {
+        return;
+    }
+    Chunk &chunk = chunks[chunk_x + chunk_y * chunk_dimensions.x];
+    if (chunk.isBaked()) {
+        unbaked_chunks.push_back(&chunk - chunks.data());
+    }
+    chunk.clearStaticObjects();
+}
+
+void ChunkMap::refreshTextures() {
+    for (Chunk &chunk : chunks) {
+        if (chunk.getStaticObjectCount() == 0 && chunk.isBaked()) {
+            continue;
+        }
+        if (chunk.isBaked()) {
+            unbaked_chunks.push_back(&chunk - chunks.data());
+        }
+        chunk.refreshTextures();
+    }
+}
+
+void ChunkMap::bake() {
+    for (std::size_t index : unbaked_chunks) {
+        chunks[index].bake();
+    }
+    unbaked_chunks.clear();
+}
+
+void ChunkMap::getChunks(const sf::FloatRect &area, std::vector<const Chunk*> &result) const {
+    result.clear();
+    sf::IntRect range = getChunkRange(area);
+    for (int y = range.top; y <= range.top + range.height; y++) {
+        for (int x = range.left; x <= range.left + range.width; x++) {
+            const Chunk &chunk = chunks[x + y * chunk_dimensions.x];
+            if (chunk.getStaticObjectCount() > 0) {
+                result.push_back(&chunk);
+            }
+        }
+    }
+}
+
+float ChunkMap::sweepStaticObjects(const AABB &aabb, const sf::Vector2f &offset, sf::Vector2f &collision_normal) const {
+    collision_normal = sf::Vector2f(0.0f, 0.0f);
+    if (offset.x == 0.0f && offset.y == 0.0f) {
+        return 1.0f;
+    }
+    // Everything we might hit is within the area covered by the whole movement
+    sf::FloatRect swept_area(
+        std::min(aabb.left, aabb.left + offset.x),
+        std::min(aabb.top, aabb.top + offset.y),
+        aabb.width + std::abs(offset.x),
+        aabb.height + std::abs(offset.y));
+    float swept_bottom = swept_area.top + swept_area.height;
+    float time_of_impact = 1.0f;
+    sf::IntRect range = getChunkRange(swept_area);
+    for (int y = range.top; y <= range.top + range.height; y++) {
+        for (int x = range.left; x <= range.left + range.width; x++) {
+            for (const AABB &other : chunks[x + y * chunk_dimensions.x].getStaticAABBs()) {
+                // The AABBs are sorted by their top, so the rest are all below us
+                if (other.top > swept_bottom) {
+                    break;
+                }
+                sf::Vector2f normal;
+                float time = aabb.sweep(other, offset, normal);
+                if (time < time_of_impact) {
+                    time_of_impact = time;
+                    collision_normal = normal;
+                }
+            }
+        }
+    }
+    return time_of_impact;
+}
+
+sf::Vector2f ChunkMap::slide(const AABB &aabb, sf::Vector2f offset) const {
+    AABB moved = aabb;
+    sf::Vector2f total_offset(0.0f, 0.0f);
+    for (int i = 0; i < MAX_SLIDES && (offset.x != 0 || offset.y != 0); i++) {
+        // Stop at solid tiles
+        offset = sweep(moved, offset);
+        // Stop at the first static object in the way
+        sf::Vector2f collision_normal;
+        float time_of_impact = sweepStaticObjects(moved, offset, collision_normal);
+        moved.move(offset * time_of_impact);
+        total_offset += offset * time_of_impact;
+        if (time_of_impact >= 1.0f) {
+            break;
+        }
+        // Slide along the object with the movement that's left
+        offset *= 1.0f - time_of_impact;
+        if (collision_normal.x != 0) {
+            offset.x = 0;
+        } else {
+            offset.y = 0;
+        }
+    }
+    return total_offset;
+}
+
+sf::IntRect ChunkMap::getChunkRange(const sf::FloatRect &area) const {
+    // Objects in the chunks above and to the left can reach into the area
+    int x_start = std::max((int) std::floor(area.left / constants::CHUNK_SIZE) - 1, 0);
+    int y_start = std::max((int) std::floor(area.top / constants::CHUNK_SIZE) - 1, 0);
+    int x_end = std::min((int) std::floor((area.left + area.width) / constants::CHUNK_SIZE), chunk_dimensions.x - 1);
+    int y_end = std::min((int) std::floor((area.top + area.height) / constants::CHUNK_SIZE), chunk_dimensions.y - 1);
+    return sf::IntRect(x_start, y_start, x_end - x_start, y_end - y_start);
+}
+
+bool ChunkMap::isColumnSolid(int x, int y_start, int y_end) const {
+    for (int y = y_start; y <= y_end; y++) {
+        if (isSolid(x, y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ChunkMap::isRowSolid(int y, int x_start, int x_end) const {
+    for (int x = x_start; x <= x_end; x++) {
+        if (isSolid(x, y)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+float ChunkMap::sweepX(const AABB &aabb, float dx) const {
+    if (dx == 0.0f) {
+        return 0.0f;
+    }
+    // The rows covered by the AABB
+    int y_start = (int) std::floor(aabb.top + EDGE_EPSILON);
+    int y_end = (int) std::floor(aabb.top + aabb.height - EDGE_EPSILON);
+    if (dx > 0.0f) {
+        // Step through the columns in front of the right edge
+        float right = aabb.left + aabb.width;
+        int x_start = (int) std::floor(right - EDGE_EPSILON) + 1;
+        int x_end = (int) std::floor(right + dx - EDGE_EPSILON);
+        for (int x = x_start; x <= x_end; x++) {
+            if (isColumnSolid(x, y_start, y_end)) {
+                // Stop at the left side of the column
+                return x - right;
+            }
+        }
+    } else {
+        // Step through the columns behind the left edge
+        float left = aabb.left;
+        int x_start = (int) std::floor(left + EDGE_EPSILON) - 1;
+        int x_end = (int) std::floor(left + dx + EDGE_EPSILON);
+        for (int x = x_start; x >= x_end; x--) {
+            if (isColumnSolid(x, y_start, y_end)) {
+                // Stop at the right side of the column
+                return x + 1 - left;
+            }
+        }
+    }
+    return dx;
+}
+
+float ChunkMap::sweepY(const AABB &aabb, float dy) const {
+    if (dy == 0.0f) {
+        return 0.0f;
+    }
+    // The columns covered by the AABB
+    int x_start = (int) std::floor(aabb.left + EDGE_EPSILON);
+    int x_end = (int) std::floor(aabb.left + aabb.width - EDGE_EPSILON);
+    if (dy > 0.0f) {
+        // Step through the rows below the bottom edge
+        float bottom = aabb.top + aabb.height;
+        int y_start = (int) std::floor(bottom - EDGE_EPSILON) + 1;
+        int y_end = (int) std::floor(bottom + dy - EDGE_EPSILON);
+        for (int y = y_start; y <= y_end; y++) {
+            if (isRowSolid(y, x_start, x_end)) {
+                // Stop at the top of the row
+                return y - bottom;
+            }
+        }
+    } else {
+        // Step through the rows above the top edge
+        float top = aabb.top;
+        int y_start = (int) std::floor(top + EDGE_EPSILON) - 1;
+        int y_end = (int) std::floor(top + dy + EDGE_EPSILON);
+        for (int y = y_start; y >= y_end; y--) {
+            if (isRowSolid(y, x_start, x_end)) {
+                // Stop at the bottom of the row
+                return y + 1 - top;
+            }
+        }
+    }
+    return dy;
+}
+
+} // namespace engine
+} // namespace rpg
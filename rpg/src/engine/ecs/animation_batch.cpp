@@ -0,0 +1,268 @@
+#include "engine/ecs/animation_batch.hpp"
+#include "engine/constants.hpp"
+#include "engine/job_system.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <type_traits>
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @brief The number of entities per job.
+*/
+static constexpr std::size_t BATCH_SIZE = 4096;
+
+void AnimationBatch::add(EntityHandle entity, resources::AnimationClipId clip_id, const resources::AnimationClip &clip, bool flip_x) {
+    if (has(entity)) {
+        setClip(sparse[entity.index], clip_id, clip, flip_x);
+        return;
+    }
+    if (entity.index >= sparse.size()) {
+        sparse.resize(entity.index + 1, NONE);
+    }
+    uint32_t slot = entities.size();
+    sparse[entity.index] = slot;
+    entities.push_back(entity);
+    clips.push_back(clip_id);
+    frames.push_back(nullptr);
+    times.push_back(0.0f);
+    frame_rates.push_back(0.0f);
+    durations.push_back(0.0f);
+    frame_counts.push_back(0);
+    loops.push_back(0);
+    flips.push_back(0);
+    current_frames.push_back(0);
+    pages.push_back(clip.getPage());
+    // Collapsed until the first call to updatePositions()
+    vertices.resize(vertices.size() + 4);
+    batches_dirty = true;
+    setClip(slot, clip_id, clip, flip_x);
+}
+
+void AnimationBatch::remove(EntityHandle entity) {
+    if (!has(entity)) {
+        return;
+    }
+    // Move the last entity into the hole to keep the arrays dense
+    uint32_t slot = sparse[entity.index];
+    uint32_t last = entities.size() - 1;
+    if (slot != last) {
+        entities[slot] = entities[last];
+        clips[slot] = clips[last];
+        frames[slot] = frames[last];
+        times[slot] = times[last];
+        frame_rates[slot] = frame_rates[last];
+        durations[slot] = durations[last];
+        frame_counts[slot] = frame_counts[last];
+        loops[slot] = loops[last];
+        flips[slot] = flips[last];
+        current_frames[slot] = current_frames[last];
+        pages[slot] = pages[last];
+        std::copy(vertices.begin() + last * 4, vertices.begin() + last * 4 + 4, vertices.begin() + slot * 4);
+        sparse[entities[slot].index] = slot;
+    }
+    entities.pop_back();
+    clips.pop_back();
+    frames.pop_back();
+    times.pop_back();
+    frame_rates.pop_back();
+    durations.pop_back();
+    frame_counts.pop_back();
+    loops.pop_back();
+    flips.pop_back();
+    current_frames.pop_back();
+    pages.pop_back();
+    vertices.resize(vertices.size() - 4);
+    sparse[entity.index] = NONE;
+    batches_dirty = true;
+}
+
+void AnimationBatch::play(EntityHandle entity, resources::AnimationClipId clip_id, const resources::AnimationClip &clip, bool flip_x) {
+    if (!has(entity)) {
+        throw std::runtime_error("AnimationBatch::" + std::string(__func__) + "(): Entity " + std::to_string(entity.index) + " isn't animated");
+    }
+    uint32_t slot = sparse[entity.index];
+    if (clips[slot] == clip_id) {
+        flips[slot] = flip_x;
+        return;
+    }
+    setClip(slot, clip_id, clip, flip_x);
+}
+
+void AnimationBatch::refreshClip(resources::AnimationClipId clip_id, const resources::AnimationClip &clip) {
+    for (std::size_t i = 0; i < entities.size(); i++) {
+        if (clips[i] != clip_id) {
+            continue;
+        }
+        frames[i] = clip.getFrames().data();
+        frame_rates[i] = clip.getFrameRate();
+        durations[i] = clip.getDuration();
+        frame_counts[i] = clip.getFrames().size();
+        loops[i] = clip.isLooping();
+        current_frames[i] = std::min(current_frames[i], frame_counts[i] - 1);
+        if (pages[i] != clip.getPage()) {
+            pages[i] = clip.getPage();
+            batches_dirty = true;
+        }
+    }
+}
+
+void AnimationBatch::update(float dt) {
+    JobSystem::getInstance().parallelFor(0, entities.size(), BATCH_SIZE, [&](std::size_t begin, std::size_t end) {
+        // Advance the time, without any branches so that the loop can be vectorised
+        for (std::size_t i = begin; i < end; i++) {
+            float time = times[i] + dt;
+            float wrapped = time - durations[i] * std::floor(time / durations[i]);
+            time = loops[i] ? wrapped : std::min(time, durations[i]);
+            times[i] = time;
+            // The clamp also catches rounding errors right at the end of a loop
+            uint32_t frame = static_cast<uint32_t>(time * frame_rates[i]);
+            current_frames[i] = std::min(frame, frame_counts[i] - 1);
+        }
+        // Write the current frames to the texture coordinates of the quads
+        for (std::size_t i = begin; i < end; i++) {
+            const sf::IntRect &rect = frames[i][current_frames[i]];
+            float left = rect.left;
+            float right = rect.left + rect.width;
+            if (flips[i]) {
+                std::swap(left, right);
+            }
+            float top = rect.top;
+            float bottom = rect.top + rect.height;
+            sf::Vertex *quad = &vertices[i * 4];
+            quad[0].texCoords = sf::Vector2f(left, top);
+            quad[1].texCoords = sf::Vector2f(right, top);
+            quad[2].texCoords = sf::Vector2f(right, bottom);
+            quad[3].texCoords = sf::Vector2f(left, bottom);
+        }
+    }, "ecs::AnimationBatch::update");
+}
+
+void AnimationBatch::updatePositions(const ComponentStore<Position> &positions, float alpha) {
+    if (batches_dirty) {
+        sortByPage();
+    }
+    JobSystem::getInstance().parallelFor(0, entities.size(), BATCH_SIZE, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            sf::Vertex *quad = &vertices[i * 4];
+            const Position *position = positions.tryGet(entities[i]);
+            if (position == nullptr) {
+                quad[0].position = quad[1].position = quad[2].position = quad[3].position = sf::Vector2f();
+                continue;
+            }
+            const sf::IntRect &rect = frames[i][current_frames[i]];
+            // Drawn somewhere between the previous and the current position
+            sf::Vector2f top_left = position->previous + (position->value - position->previous) * alpha;
+            sf::Vector2f size(rect.width * constants::WORLD_SPRITE_SCALE, rect.height * constants::WORLD_SPRITE_SCALE);
+            quad[0].position = top_left;
+            quad[1].position = top_left + sf::Vector2f(size.x, 0.0f);
+            quad[2].position = top_left + size;
+            quad[3].position = top_left + sf::Vector2f(0.0f, size.y);
+        }
+    }, "ecs::AnimationBatch::updatePositions");
+}
+
+void AnimationBatch::reserve(std::size_t capacity) {
+    entities.reserve(capacity);
+    clips.reserve(capacity);
+    frames.reserve(capacity);
+    times.reserve(capacity);
+    frame_rates.reserve(capacity);
+    durations.reserve(capacity);
+    frame_counts.reserve(capacity);
+    loops.reserve(capacity);
+    flips.reserve(capacity);
+    current_frames.reserve(capacity);
+    pages.reserve(capacity);
+    vertices.reserve(capacity * 4);
+}
+
+void AnimationBatch::reserveAdditional(std::size_t count) {
+    if (entities.size() + count > entities.capacity()) {
+        reserve(std::max(entities.size() + count, entities.capacity() * 2));
+    }
+}
+
+void AnimationBatch::clear() {
+    entities.clear();
+    sparse.clear();
+    clips.clear();
+    frames.clear();
+    times.clear();
+    frame_rates.clear();
+    durations.clear();
+    frame_counts.clear();
+    loops.clear();
+    flips.clear();
+    current_frames.clear();
+    pages.clear();
+    vertices.clear();
+    batches.clear();
+    batches_dirty = false;
+}
+
+void AnimationBatch::setClip(uint32_t slot, resources::AnimationClipId clip_id, const resources::AnimationClip &clip, bool flip_x) {
+    clips[slot] = clip_id;
+    frames[slot] = clip.getFrames().data();
+    times[slot] = 0.0f;
+    frame_rates[slot] = clip.getFrameRate();
+    durations[slot] = clip.getDuration();
+    frame_counts[slot] = clip.getFrames().size();
+    loops[slot] = clip.isLooping();
+    flips[slot] = flip_x;
+    current_frames[slot] = 0;
+    if (pages[slot] != clip.getPage()) {
+        pages[slot] = clip.getPage();
+        batches_dirty = true;
+    }
+}
+
+void AnimationBatch::sortByPage() {
+    // Nearly everything is on the first page, so there's usually nothing to move
+    if (!std::is_sorted(pages.begin(), pages.end())) {
+        std::vector<uint32_t> order(entities.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+            return pages[a] < pages[b];
+        });
+        auto permute = [&order](auto &values, std::size_t stride) {
+            std::remove_reference_t<decltype(values)> sorted;
+            sorted.reserve(values.size());
+            for (uint32_t slot : order) {
+                sorted.insert(sorted.end(), values.begin() + slot * stride, values.begin() + (slot + 1) * stride);
+            }
+            values.swap(sorted);
+        };
+        permute(entities, 1);
+        permute(clips, 1);
+        permute(frames, 1);
+        permute(times, 1);
+        permute(frame_rates, 1);
+        permute(durations, 1);
+        permute(frame_counts, 1);
+        permute(loops, 1);
+        permute(flips, 1);
+        permute(current_frames, 1);
+        permute(pages, 1);
+        permute(vertices, 4);
+        for (uint32_t slot = 0; slot < entities.size(); slot++) {
+            sparse[entities[slot].index] = slot;
+        }
+    }
+    batches.clear();
+    for (uint32_t slot = 0; slot < entities.size(); slot++) {
+        if (batches.empty() || batches.back().page != pages[slot]) {
+            batches.push_back({pages[slot], slot * 4, 0});
+        }
+        batches.back().count += 4;
+    }
+    batches_dirty = false;
+}
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,171 @@
+#include "engine/ecs/draw_order.hpp"
+#include "engine/constants.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @brief How many places each key may move on average before insertion sort
+ * is given up on. The order only changes that much when a lot of entities were
+ * spawned at once, or the AnimationBatch was sorted by page, and insertion sort
+ * is quadratic in the worst case.
+*/
+static constexpr std::size_t MAX_MOVES_PER_KEY = 16;
+/**
+ * @brief The lower half of a key, which holds the slot and whether or not it's animated.
+*/
+static constexpr uint64_t SLOT_MASK = 0xFFFFFFFF;
+
+void DrawOrder::update(const Registry &registry, const sf::FloatRect &viewport, float alpha) {
+    const ComponentStore<Position> &positions = registry.getStore<Position>();
+    const ComponentStore<Collider> &colliders = registry.getStore<Collider>();
+    const ComponentStore<Sprite> &sprites = registry.getStore<Sprite>();
+    const std::vector<Sprite> &sprite_components = sprites.getComponents();
+    const std::vector<EntityHandle> &sprite_entities = sprites.getEntities();
+    const AnimationBatch &animation_batch = registry.getAnimationBatch();
+    const std::vector<EntityHandle> &animated_entities = animation_batch.getEntities();
+    const std::vector<sf::Vertex> &vertices = animation_batch.getVertices();
+    resize(sprite_components.size(), animated_entities.size());
+    // Sorted by the top of the collider, like the game objects they're merged with
+    auto get_y = [&colliders](EntityHandle entity, float top) {
+        const Collider *collider = colliders.tryGet(entity);
+        return collider != nullptr ? top + collider->offset.y : top;
+    };
+    // The slots are visited in order, rather than in draw order, to keep the reads sequential
+    for (std::size_t slot = 0; slot < sprite_components.size(); slot++) {
+        const Position *position = positions.tryGet(sprite_entities[slot]);
+        if (position == nullptr) {
+            sprite_visible[slot] = false;
+            continue;
+        }
+        const sf::IntRect &rect = sprite_components[slot].texture_rect;
+        sf::FloatRect bounds(getTopLeft(*position, alpha),
+            sf::Vector2f(rect.width * constants::WORLD_SPRITE_SCALE, rect.height * constants::WORLD_SPRITE_SCALE));
+        sprite_ys[slot] = get_y(sprite_entities[slot], bounds.top);
+        sprite_visible[slot] = viewport.intersects(bounds);
+    }
+    // The animated entities already have their quads
+    for (std::size_t slot = 0; slot < animated_entities.size(); slot++) {
+        const sf::Vector2f &top_left = vertices[slot * 4].position;
+        sf::FloatRect bounds(top_left, vertices[slot * 4 + 2].position - top_left);
+        animated_ys[slot] = get_y(animated_entities[slot], top_left.y);
+        animated_visible[slot] = viewport.intersects(bounds);
+    }
+    for (uint64_t &key : order) {
+        uint32_t slot = static_cast<uint32_t>(key & SLOT_MASK) >> 1;
+        float y = key & 1 ? animated_ys[slot] : sprite_ys[slot];
+        key = (static_cast<uint64_t>(getSortableBits(y)) << 32) | (key & SLOT_MASK);
+    }
+    sort();
+    // Every entry is written, but only kept if it's in view, which saves a branch per entry
+    visible_entries.resize(order.size());
+    std::size_t visible_count = 0;
+    for (uint64_t key : order) {
+        uint32_t slot = static_cast<uint32_t>(key & SLOT_MASK) >> 1;
+        bool animated = key & 1;
+        Entry &entry = visible_entries[visible_count];
+        entry.y = animated ? animated_ys[slot] : sprite_ys[slot];
+        entry.slot = slot;
+        entry.animated = animated;
+        visible_count += animated ? animated_visible[slot] : sprite_visible[slot];
+    }
+    visible_entries.resize(visible_count);
+}
+
+uint32_t DrawOrder::getPage(const Registry &registry, const Entry &entry) {
+    if (entry.animated) {
+        return registry.getAnimationBatch().getPages()[entry.slot];
+    }
+    return registry.getStore<Sprite>().getComponents()[entry.slot].page;
+}
+
+void DrawOrder::appendQuad(const Registry &registry, const Entry &entry, float alpha, sf::VertexArray &vertex_array) {
+    if (entry.animated) {
+        const sf::Vertex *quad = &registry.getAnimationBatch().getVertices()[entry.slot * 4];
+        for (std::size_t i = 0; i < 4; i++) {
+            vertex_array.append(quad[i]);
+        }
+        return;
+    }
+    const ComponentStore<Sprite> &sprites = registry.getStore<Sprite>();
+    const Sprite &sprite = sprites.getComponents()[entry.slot];
+    // Only entities with a Position are in view
+    const Position &position = registry.getStore<Position>().get(sprites.getEntities()[entry.slot]);
+    const sf::IntRect &rect = sprite.texture_rect;
+    sf::Vector2f top_left = getTopLeft(position, alpha);
+    sf::Vector2f size(rect.width * constants::WORLD_SPRITE_SCALE, rect.height * constants::WORLD_SPRITE_SCALE);
+    float left = rect.left;
+    float right = rect.left + rect.width;
+    if (sprite.flip_x) {
+        std::swap(left, right);
+    }
+    float top = rect.top;
+    float bottom = rect.top + rect.height;
+    vertex_array.append(sf::Vertex(top_left, sf::Vector2f(left, top)));
+    vertex_array.append(sf::Vertex(top_left + sf::Vector2f(size.x, 0.0f), sf::Vector2f(right, top)));
+    vertex_array.append(sf::Vertex(top_left + size, sf::Vector2f(right, bottom)));
+    vertex_array.append(sf::Vertex(top_left + sf::Vector2f(0.0f, size.y), sf::Vector2f(left, bottom)));
+}
+
+void DrawOrder::resize(std::size_t sprite_count, std::size_t animated_count) {
+    if (sprite_count < sprite_ys.size() || animated_count < animated_ys.size()) {
+        // Entities were removed, and the last slots were moved into their holes
+        order.erase(std::remove_if(order.begin(), order.end(), [&](uint64_t key) {
+            uint32_t slot = static_cast<uint32_t>(key & SLOT_MASK) >> 1;
+            return slot >= (key & 1 ? animated_count : sprite_count);
+        }), order.end());
+    }
+    // New keys are sorted into place on the next sort()
+    for (std::size_t slot = sprite_ys.size(); slot < sprite_count; slot++) {
+        order.push_back(static_cast<uint64_t>(slot) << 1);
+    }
+    for (std::size_t slot = animated_ys.size(); slot < animated_count; slot++) {
+        order.push_back((static_cast<uint64_t>(slot) << 1) | 1);
+    }
+    sprite_ys.resize(sprite_count, 0.0f);
+    sprite_visible.resize(sprite_count, false);
+    animated_ys.resize(animated_count, 0.0f);
+    animated_visible.resize(animated_count, false);
+}
+
+void DrawOrder::sort() {
+    // Insertion sort, which is close to linear since the order is almost sorted
+    std::size_t max_moves = order.size() * MAX_MOVES_PER_KEY;
+    std::size_t moves = 0;
+    for (std::size_t i = 1; i < order.size(); i++) {
+        uint64_t key = order[i];
+        std::size_t j = i;
+        while (j > 0 && key < order[j - 1]) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = key;
+        moves += i - j;
+        if (moves > max_moves) {
+            std::sort(order.begin(), order.end());
+            return;
+        }
+    }
+}
+
+sf::Vector2f DrawOrder::getTopLeft(const Position &position, float alpha) {
+    // Drawn somewhere between the previous and the current position
+    return position.previous + (position.value - position.previous) * alpha;
+}
+
+uint32_t DrawOrder::getSortableBits(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // Negative floats sort backwards, so all of their bits are flipped, and
+    // the sign bit is flipped for the rest to put them after the negative ones
+    return bits & 0x80000000 ? ~bits : bits | 0x80000000;
+}
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,39 @@
+#include "engine/ecs/registry.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+EntityHandle Registry::create() {
+    EntityHandle entity;
+    if (!free_indices.empty()) {
+        entity.index = free_indices.back();
+        free_indices.pop_back();
+    } else {
+        entity.index = generations.size();
+        generations.push_back(0);
+    }
+    entity.generation = generations[entity.index];
+    return entity;
+}
+
+void Registry::destroy(EntityHandle entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+    std::apply([entity](auto&... store) { (store.remove(entity), ...); }, stores);
+    animation_batch.remove(entity);
+    // Any handles still referring to the entity are now out of date
+    generations[entity.index]++;
+    free_indices.push_back(entity.index);
+}
+
+void Registry::reserve(std::size_t capacity) {
+    generations.reserve(capacity);
+    std::apply([capacity](auto&... store) { (store.reserve(capacity), ...); }, stores);
+    animation_batch.reserve(capacity);
+}
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
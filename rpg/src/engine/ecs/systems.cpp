@@ -0,0 +1,96 @@
+#include "engine/ecs/systems.hpp"
+#include "engine/constants.hpp"
+#include "engine/job_system.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+/**
+ * @brief The number of entities per job in the parallel systems.
+*/
+static constexpr std::size_t BATCH_SIZE = 1024;
+
+void followFlowField(Registry &registry, const FlowField &flow_field, const std::vector<ScheduledUpdate> &updates) {
+    const ComponentStore<FlowFieldFollower> &followers = registry.getStore<FlowFieldFollower>();
+    const ComponentStore<Position> &positions = registry.getStore<Position>();
+    const ComponentStore<Collider> &colliders = registry.getStore<Collider>();
+    ComponentStore<Velocity> &velocities = registry.getStore<Velocity>();
+    JobSystem::getInstance().parallelFor(0, updates.size(), BATCH_SIZE, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            EntityHandle entity = updates[i].entity;
+            if (!followers.has(entity)) {
+                continue;
+            }
+            const Position *position = positions.tryGet(entity);
+            Velocity *velocity = velocities.tryGet(entity);
+            if (position == nullptr || velocity == nullptr) {
+                continue;
+            }
+            sf::Vector2f center = position->value;
+            const Collider *collider = colliders.tryGet(entity);
+            if (collider != nullptr) {
+                center += collider->offset + collider->size / 2.0f;
+            }
+            velocity->direction = flow_field.getDirection(center);
+        }
+    }, "ecs::followFlowField");
+}
+
+void updateMovement(Registry &registry, const ChunkMap *chunk_map, const std::vector<ScheduledUpdate> &updates) {
+    ComponentStore<Position> &positions = registry.getStore<Position>();
+    const ComponentStore<Collider> &colliders = registry.getStore<Collider>();
+    const ComponentStore<Velocity> &velocities = registry.getStore<Velocity>();
+    // Every entity only touches its own components, so the batches can run in parallel
+    JobSystem::getInstance().parallelFor(0, updates.size(), BATCH_SIZE, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            const ScheduledUpdate &update = updates[i];
+            Position *position = positions.tryGet(update.entity);
+            if (position == nullptr) {
+                continue;
+            }
+            position->previous = position->value;
+            const Velocity *velocity = velocities.tryGet(update.entity);
+            if (velocity == nullptr || (velocity->direction.x == 0 && velocity->direction.y == 0)) {
+                continue;
+            }
+            sf::Vector2f offset = velocity->direction * velocity->speed * update.dt;
+            const Collider *collider = colliders.tryGet(update.entity);
+            if (chunk_map != nullptr && collider != nullptr) {
+                offset = chunk_map->slide(AABB(position->value + collider->offset, collider->size), offset);
+            }
+            position->value += offset;
+            if (!update.interpolate) {
+                position->previous = position->value;
+            }
+        }
+    }, "ecs::updateMovement");
+}
+
+void updateAnimations(Registry &registry, const std::vector<AnimationTable> &tables,
+    const resources::ResourceManager &resource_manager, const std::vector<ScheduledUpdate> &updates) {
+    ComponentStore<Animator> &animators = registry.getStore<Animator>();
+    const ComponentStore<Velocity> &velocities = registry.getStore<Velocity>();
+    AnimationBatch &animation_batch = registry.getAnimationBatch();
+    // Not in parallel, switching clips can reorder the animation batch
+    for (const ScheduledUpdate &update : updates) {
+        Animator *animator = animators.tryGet(update.entity);
+        if (animator == nullptr || !animation_batch.has(update.entity)) {
+            continue;
+        }
+        const Velocity *velocity = velocities.tryGet(update.entity);
+        sf::Vector2f direction = velocity != nullptr ? velocity->direction : sf::Vector2f();
+        const AnimationTable::Slot &slot = tables[animator->table].getMovement(direction, animator->last_direction);
+        if (direction.x != 0 || direction.y != 0) {
+            animator->last_direction = direction;
+        }
+        if (slot.clip == resources::AnimationClip::INVALID_ID) {
+            continue;
+        }
+        animation_batch.play(update.entity, slot.clip, resource_manager.getAnimation(slot.clip), slot.flip);
+    }
+}
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
@@ -0,0 +1,148 @@
+#include "engine/ecs/tick_scheduler.hpp"
+#include "engine/constants.hpp"
+
+namespace rpg {
+namespace engine {
+namespace ecs {
+
+void TickScheduler::schedule(Registry &registry, const sf::Vector2f &focus, float dt) {
+    tick++;
+    updates.clear();
+    ComponentStore<SimulationLod> &lods = registry.getStore<SimulationLod>();
+    const ComponentStore<Position> &positions = registry.getStore<Position>();
+    addNewEntities(lods, positions, focus, dt);
+    for (std::size_t list = 0; list < LIST_COUNT; list++) {
+        reclassify(lods, positions, list, focus, dt);
+    }
+    // An entity is due when its index plus the tick is a multiple of the interval
+    scheduleList(lods, getList(NEAR, 0), dt);
+    scheduleList(lods, getList(MID, constants::LOD_MID_INTERVAL - tick % constants::LOD_MID_INTERVAL), dt);
+    scheduleList(lods, getList(FAR, constants::LOD_FAR_INTERVAL - tick % constants::LOD_FAR_INTERVAL), dt);
+    for (uint8_t level = NEAR; level <= FROZEN; level++) {
+        std::size_t first = getList(static_cast<Level>(level), 0);
+        counts[level] = 0;
+        for (std::size_t list = first; list < first + getInterval(static_cast<Level>(level)); list++) {
+            counts[level] += lists[list].size();
+        }
+    }
+}
+
+void TickScheduler::addNewEntities(ComponentStore<SimulationLod> &lods, const ComponentStore<Position> &positions, const sf::Vector2f &focus, float dt) {
+    const std::vector<Position> &position_components = positions.getComponents();
+    const std::vector<EntityHandle> &entities = positions.getEntities();
+    // New entities are added to the end of the store, so start there and stop
+    // as soon as every entity is accounted for
+    for (std::size_t i = entities.size(); i > 0 && lods.size() < entities.size(); i--) {
+        EntityHandle entity = entities[i - 1];
+        if (lods.has(entity)) {
+            continue;
+        }
+        sf::Vector2f offset = position_components[i - 1].value - focus;
+        // New entities are classified right away
+        SimulationLod &lod = lods.add(entity, SimulationLod{getLevel(offset.x * offset.x + offset.y * offset.y), tick - 1});
+        insert(entity, lod, dt);
+    }
+}
+
+void TickScheduler::reclassify(ComponentStore<SimulationLod> &lods, const ComponentStore<Position> &positions, std::size_t list, const sf::Vector2f &focus, float dt) {
+    std::vector<EntityHandle> &entities = lists[list];
+    // Only a slice of the entities have their distance checked each tick
+    std::size_t i = tick % constants::LOD_RECLASSIFY_TICKS;
+    while (i < entities.size()) {
+        EntityHandle entity = entities[i];
+        SimulationLod *lod = lods.tryGet(entity);
+        const Position *position = positions.tryGet(entity);
+        if (lod == nullptr || position == nullptr) {
+            lods.remove(entity);
+            erase(list, i);
+            // The entity moved into its place is checked next
+            continue;
+        }
+        sf::Vector2f offset = position->value - focus;
+        Level level = getLevel(offset.x * offset.x + offset.y * offset.y);
+        if (level == lod->level) {
+            i += constants::LOD_RECLASSIFY_TICKS;
+            continue;
+        }
+        if (lod->level == FROZEN) {
+            // The time spent frozen is skipped, rather than simulated all at once
+            lod->last_tick = tick - 1;
+        }
+        lod->level = level;
+        erase(list, i);
+        insert(entity, *lod, dt);
+    }
+}
+
+void TickScheduler::scheduleList(ComponentStore<SimulationLod> &lods, std::size_t list, float dt) {
+    std::vector<EntityHandle> &entities = lists[list];
+    std::size_t i = 0;
+    while (i < entities.size()) {
+        SimulationLod *lod = lods.tryGet(entities[i]);
+        if (lod == nullptr) {
+            // Destroyed since it was added
+            erase(list, i);
+            continue;
+        }
+        if (lod->last_tick != tick) {
+            updates.push_back({entities[i], (tick - lod->last_tick) * dt, lod->level == NEAR});
+            lod->last_tick = tick;
+        }
+        i++;
+    }
+}
+
+void TickScheduler::insert(EntityHandle entity, SimulationLod &lod, float dt) {
+    Level level = static_cast<Level>(lod.level);
+    lists[getList(level, entity.index)].push_back(entity);
+    // Don't make an entity that's already been waiting longer than the interval wait for its turn
+    if (level != FROZEN && tick - lod.last_tick >= getInterval(level)) {
+        updates.push_back({entity, (tick - lod.last_tick) * dt, level == NEAR});
+        lod.last_tick = tick;
+    }
+}
+
+void TickScheduler::erase(std::size_t list, std::size_t index) {
+    std::vector<EntityHandle> &entities = lists[list];
+    entities[index] = entities.back();
+    entities.pop_back();
+}
+
+std::size_t TickScheduler::getList(Level level, uint32_t index) {
+    switch (level) {
+        case NEAR:
+            return 0;
+        case MID:
+            return 1 + index % constants::LOD_MID_INTERVAL;
+        case FAR:
+            return 1 + constants::LOD_MID_INTERVAL + index % constants::LOD_FAR_INTERVAL;
+        default:
+            return LIST_COUNT - 1;
+    }
+}
+
+TickScheduler::Level TickScheduler::getLevel(float distance_squared) {
+    if (distance_squared < constants::LOD_NEAR_RADIUS * constants::LOD_NEAR_RADIUS) {
+        return NEAR;
+    } else if (distance_squared < constants::LOD_MID_RADIUS * constants::LOD_MID_RADIUS) {
+        return MID;
+    } else if (distance_squared < constants::LOD_FAR_RADIUS * constants::LOD_FAR_RADIUS) {
+        return FAR;
+    }
+    return FROZEN;
+}
+
+uint32_t TickScheduler::getInterval(Level level) {
+    switch (level) {
+        case MID:
+            return constants::LOD_MID_INTERVAL;
+        case FAR:
+            return constants::LOD_FAR_INTERVAL;
+        default:
+            return 1;
+    }
+}
+
+} // namespace ecs
+} // namespace engine
+} // namespace rpg
@@ -1,11 +1,12 @@
 #include "engine/entity.hpp"
 #include "engine/constants.hpp"
+#include "resources/resource_manager.hpp"
 
 namespace rpg {
 namespace engine {
 
 Entity::Entity(const sf::Vector2f &position, const resources::GameRegistry::EntityData &data) 
-    : MobileObject(position, data) {
+    : MobileObject(position, data), animation_table(data) {
     this->health = max_health;
     this->max_health = max_health;
     // This should be done somewhere else?
@@ -15,20 +16,20 @@ Entity::Entity(const sf::Vector2f &position, const resources::GameRegistry::Enti
         // If no animations are provided throw an error
         throw std::runtime_error("Entity::" + std::string(__func__) +  "(): No animations provided for entity: " + data.registry_name + "");
     }
-    this->animations = data.animations;
 }
 
 void Entity::update(float dt) {
     MobileObject::update(dt);
-    std::string key;
-    bool flip = false;
-    if (isMoving()) {
-        key = getMovementAnimationKey(flip);
-    } else {
-        key = getIdleAnimationKey(flip);
+    const AnimationTable::Slot &slot = animation_table.getMovement(direction, previous_direction);
+    if (slot.clip == resources::AnimationClip::INVALID_ID) {
+        return;
     }
-    sf::IntRect frame = animations.at(key).getFrame(dt);
-    vertex_quad.setTextureRect(frame, flip, false);
+    const resources::ResourceManager &resource_manager = resources::GameRegistry::getInstance().getResourceManager();
+    animation_player.play(slot.clip);
+    const resources::AnimationClip &clip = resource_manager.getAnimation(slot.clip);
+    animation_player.advance(clip, dt);
+    vertex_quad.setTextureRect(animation_player.getFrame(clip), slot.flip, false);
+    vertex_quad.setPage(clip.getPage());
 }
 
 void Entity::damage(int amount) {
@@ -45,35 +46,5 @@ void Entity::heal(int amount) {
     }
 }
 
-std::string Entity::getIdleAnimationKey(bool &flip) const {
-    if (previous_direction.y > 0) {
-        return registry_name + "_" + IDLE_DOWN;
-    } else if (previous_direction.y < 0) {
-        return registry_name + "_" + IDLE_UP;
-    } else if (previous_direction.x < 0) {
-        flip = true;
-        return registry_name + "_" + IDLE_LEFT_RIGHT;
-    } else if (previous_direction.x > 0) {
-        flip = false;
-        return registry_name + "_" + IDLE_LEFT_RIGHT;
-    }
-    return registry_name + "_" + IDLE_DOWN;
-}
-
-std::string Entity::getMovementAnimationKey(bool &flip) const {
-    if (direction.y > 0) {
-        return registry_name + "_" + WALK_DOWN;
-    } else if (direction.y < 0) {
-        return registry_name + "_" + WALK_UP;
-    } else if (direction.x < 0) {
-        flip = true;
-        return registry_name + "_" + WALK_LEFT_RIGHT;
-    } else if (direction.x > 0) {
-        flip = false;
-        return registry_name + "_" + WALK_LEFT_RIGHT;
-    }
-    return registry_name + "_" + WALK_DOWN;
-}
-
 } // namespace engine
 } // namespace rpg
\ No newline at end of file
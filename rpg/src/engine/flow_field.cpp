@@ -0,0 +1,182 @@
+#include "engine/flow_field.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @brief The neighbours of a tile, straight ones first so they win ties.
+ * The last entry means "don't move".
+*/
+static const sf::Vector2i OFFSETS[9] = {
+    sf::Vector2i(1, 0), sf::Vector2i(-1, 0), sf::Vector2i(0, 1), sf::Vector2i(0, -1),
+    sf::Vector2i(1, 1), sf::Vector2i(-1, 1), sf::Vector2i(1, -1), sf::Vector2i(-1, -1),
+    sf::Vector2i(0, 0)
+};
+
+/**
+ * @brief The normalized directions matching OFFSETS.
+*/
+static const float DIAGONAL = 1.0f / std::sqrt(2.0f);
+static const sf::Vector2f DIRECTIONS[9] = {
+    sf::Vector2f(1, 0), sf::Vector2f(-1, 0), sf::Vector2f(0, 1), sf::Vector2f(0, -1),
+    sf::Vector2f(DIAGONAL, DIAGONAL), sf::Vector2f(-DIAGONAL, DIAGONAL),
+    sf::Vector2f(DIAGONAL, -DIAGONAL), sf::Vector2f(-DIAGONAL, -DIAGONAL),
+    sf::Vector2f(0, 0)
+};
+
+FlowField::FlowField(const ChunkMap &chunk_map, int radius, int max_drift) : chunk_map(chunk_map), radius(radius), max_drift(max_drift) {
+    if (radius <= 0) {
+        throw std::invalid_argument("FlowField::" + std::string(__func__) + "(): Radius must be positive");
+    }
+    if (max_drift < 0) {
+        throw std::invalid_argument("FlowField::" + std::string(__func__) + "(): Drift must not be negative");
+    }
+    size = 2 * radius + 1;
+}
+
+void FlowField::setGoal(const sf::Vector2i &goal) {
+    if (!has_goal || (phase == Phase::DONE && goal != front.goal)) {
+        start(goal);
+        return;
+    }
+    if (phase == Phase::DONE) {
+        return;
+    }
+    // Restarting throws away the work done so far, so only do it if the field
+    // being computed would be too far off to be worth finishing
+    if (std::max(std::abs(goal.x - back.goal.x), std::abs(goal.y - back.goal.y)) > max_drift) {
+        start(goal);
+        return;
+    }
+    pending_goal = goal;
+    has_pending_goal = goal != back.goal;
+}
+
+bool FlowField::update(int budget) {
+    while (budget > 0 && phase != Phase::DONE) {
+        if (phase == Phase::INTEGRATION) {
+            if (queue_head == queue.size()) {
+                phase = Phase::DIRECTIONS;
+                continue;
+            }
+            // Breadth-first search outwards from the goal
+            uint32_t index = queue[queue_head++];
+            int x = index % size;
+            int y = index / size;
+            for (int i = 0; i < 4; i++) {
+                int next_x = x + OFFSETS[i].x;
+                int next_y = y + OFFSETS[i].y;
+                if (next_x < 0 || next_x >= size || next_y < 0 || next_y >= size) {
+                    continue;
+                }
+                uint32_t next = next_x + next_y * size;
+                if (back.distances[next] != UNREACHABLE || !isWalkable(next_x, next_y)) {
+                    continue;
+                }
+                back.distances[next] = back.distances[index] + 1;
+                queue.push_back(next);
+            }
+        } else {
+            if (next_direction == back.directions.size()) {
+                // The new field is done, start using it
+                std::swap(front, back);
+                phase = Phase::DONE;
+                if (has_pending_goal) {
+                    // The goal moved while this one was being computed
+                    start(pending_goal);
+                }
+                break;
+            }
+            back.directions[next_direction] = findDirection(next_direction % size, next_direction / size);
+            next_direction++;
+        }
+        budget--;
+    }
+    return phase == Phase::DONE;
+}
+
+void FlowField::invalidate() {
+    if (!has_goal) {
+        return;
+    }
+    // The tiles changed, so the field being computed is out of date as well
+    if (has_pending_goal) {
+        start(pending_goal);
+    } else {
+        start(phase == Phase::DONE ? front.goal : back.goal);
+    }
+}
+
+sf::Vector2f FlowField::getDirection(const sf::Vector2f &position) const {
+    if (front.directions.empty()) {
+        return sf::Vector2f(0, 0);
+    }
+    int x = (int) std::floor(position.x) - front.origin.x;
+    int y = (int) std::floor(position.y) - front.origin.y;
+    if (x < 0 || x >= size || y < 0 || y >= size) {
+        return sf::Vector2f(0, 0);
+    }
+    return DIRECTIONS[front.directions[x + y * size]];
+}
+
+void FlowField::start(const sf::Vector2i &goal) {
+    has_goal = true;
+    has_pending_goal = false;
+    back.goal = goal;
+    back.origin = goal - sf::Vector2i(radius, radius);
+    back.distances.assign(size * size, UNREACHABLE);
+    back.directions.assign(size * size, NO_DIRECTION);
+    queue.clear();
+    queue_head = 0;
+    next_direction = 0;
+    phase = Phase::INTEGRATION;
+    // The goal is always in the middle of the window
+    if (isWalkable(radius, radius)) {
+        uint32_t center = radius + radius * size;
+        back.distances[center] = 0;
+        queue.push_back(center);
+    }
+}
+
+bool FlowField::isWalkable(int x, int y) const {
+    return !chunk_map.isSolid(back.origin.x + x, back.origin.y + y);
+}
+
+uint8_t FlowField::findDirection(int x, int y) const {
+    uint16_t best = back.distances[x + y * size];
+    if (best == UNREACHABLE || best == 0) {
+        return NO_DIRECTION;
+    }
+    auto distance = [this](int x, int y) -> uint16_t {
+        if (x < 0 || x >= size || y < 0 || y >= size) {
+            return UNREACHABLE;
+        }
+        return back.distances[x + y * size];
+    };
+    uint8_t direction = NO_DIRECTION;
+    for (uint8_t i = 0; i < 8; i++) {
+        int next_x = x + OFFSETS[i].x;
+        int next_y = y + OFFSETS[i].y;
+        uint16_t next = distance(next_x, next_y);
+        if (next >= best) {
+            continue;
+        }
+        // Don't cut corners, both straight neighbours must be walkable to move diagonally
+        if (i >= 4 && (distance(next_x, y) == UNREACHABLE || distance(x, next_y) == UNREACHABLE)) {
+            continue;
+        }
+        best = next;
+        direction = i;
+    }
+    return direction;
+}
+
+} // namespace engine
+} // namespace rpg
@@ -17,9 +17,16 @@ void GameStateManager::changeState(std::unique_ptr<GameState> new_state) {
 
 void GameStateManager::update(float delta_time) {
     current_state->update(delta_time);
+}
+
+void GameStateManager::updateUI(float delta_time) {
     current_state->updateUI(delta_time);
 }
 
+void GameStateManager::interpolate(float alpha) {
+    current_state->interpolate(alpha);
+}
+
 void GameStateManager::draw(sf::RenderTarget &target, sf::RenderStates states) const {
     current_state->draw(target, states);
     current_state->drawUI(target, states);
@@ -1,6 +1,9 @@
 #include "engine/game_state/states/loading_state.hpp"
+#include "engine/constants.hpp"
 #include <chrono>
 #include <thread>
+#include <random>
+#include <cmath>
 
 namespace rpg {
 namespace engine {
@@ -22,6 +25,37 @@ void LoadingState::update(float delta_time) {
         // Create some stuff relative to the world center
         sf::Vector2i center = world_dimensions / 2;
         world->createPlayer(sf::Vector2i(center.x + 2, center.y + 2));
+        if (constants::DEBUG_CROWD_SIZE > 0) {
+            // A crowd within reach of the flow field, so it comes after the player straight away
+            const ChunkMap &chunk_map = world->getChunkMap();
+            const AABB &footprint = game_registry.getEntityData("entity.player").footprint;
+            // Nobody may start out stuck in a tile they can't walk on
+            auto is_walkable = [&chunk_map, &footprint](const sf::Vector2f &position) {
+                sf::Vector2f top_left = position + footprint.getPosition();
+                sf::Vector2f bottom_right = top_left + footprint.getSize();
+                for (int y = std::floor(top_left.y); y < std::ceil(bottom_right.y); y++) {
+                    for (int x = std::floor(top_left.x); x < std::ceil(bottom_right.x); x++) {
+                        if (chunk_map.isSolid(x, y)) {
+                            return false;
+                        }
+                    }
+                }
+                return true;
+            };
+            std::mt19937 random(1337);
+            std::uniform_real_distribution<float> offset(-constants::FLOW_FIELD_RADIUS / 2.0f, constants::FLOW_FIELD_RADIUS / 2.0f);
+            std::vector<sf::Vector2f> crowd_positions;
+            // Give up at some point, in case there's hardly any land around the player
+            int max_attempts = constants::DEBUG_CROWD_SIZE * 16;
+            for (int i = 0; i < max_attempts && crowd_positions.size() < static_cast<std::size_t>(constants::DEBUG_CROWD_SIZE); i++) {
+                sf::Vector2f position(center.x + offset(random), center.y + offset(random));
+                if (is_walkable(position)) {
+                    crowd_positions.push_back(position);
+                }
+            }
+            std::vector<ecs::EntityHandle> crowd;
+            world->spawnEntities("entity.player", crowd_positions, crowd);
+        }
         // world->createGameObject(sf::Vector2i(center.x + 5, center.y + 5), "rock");
         // world->createGameObject(sf::Vector2i(center.x + 10, center.y + 3), "bush_short");
         // world->createGameObject(sf::Vector2i(center.x + 7, center.y + 2), "tree_stump");
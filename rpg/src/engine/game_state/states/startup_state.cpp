@@ -1,6 +1,7 @@
 #include "engine/game_state/states/startup_state.hpp"
 #include "engine/game_state/states/loading_state.hpp"
 #include "resources/game_registry.hpp"
+#include "resources/virtual_file_system.hpp"
 
 namespace rpg {
 namespace engine {
@@ -8,7 +9,12 @@ namespace game_state {
 
 StartupState::StartupState(GameStateManager *game_state_manager) 
     : GameState(game_state_manager) {
-    logo_texture.loadFromFile(resources::GameRegistry::getResourcesFolder() + "/logo.png");
+    resources::VirtualFileSystem &file_system = resources::VirtualFileSystem::getInstance();
+    std::string logo_path = resources::GameRegistry::getResourcesFolder() + "/logo.png";
+    if (file_system.exists(logo_path)) {
+        resources::VirtualFileSystem::File logo_file = file_system.open(logo_path);
+        logo_texture.loadFromMemory(logo_file.data, logo_file.size);
+    }
     logo_sprite.setTexture(logo_texture);
     logo_sprite.setPosition(0, 0);
 }
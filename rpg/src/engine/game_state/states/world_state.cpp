@@ -73,10 +73,30 @@ WorldState::WorldState(GameStateManager *game_state_manager, std::shared_ptr<Wor
     button_list->addButton("Amet", [](){ std::cout << "Amet" << std::endl; });
     ui_manager->addUIElement(std::move(button));
     ui_manager->addUIElement(std::move(button_list));
+
+    if (engine::constants::HOT_RELOAD) {
+        resources::GameRegistry::getInstance().enableHotReload();
+    }
 }
 
 void WorldState::update(float delta_time) {
+    if (engine::constants::HOT_RELOAD) {
+        std::vector<resources::AnimationClipId> reloaded_clips;
+        bool repacked = resources::GameRegistry::getInstance().pollHotReload(reloaded_clips);
+        if (!reloaded_clips.empty()) {
+            world->refreshAnimations(reloaded_clips);
+        }
+        if (repacked) {
+            world->refreshTextures();
+            ui_manager->refreshTextures();
+        }
+    }
     world->update(delta_time);
+}
+
+void WorldState::interpolate(float alpha) {
+    world->interpolate(alpha);
+    // The view follows the interpolated player, so it has to be updated per frame
     world->updateView(world_view);
 }
 
@@ -0,0 +1,220 @@
+#include "engine/job_system.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @brief The index of the worker running on this thread, if any.
+*/
+static thread_local std::size_t worker_index = static_cast<std::size_t>(-1);
+
+JobSystem::JobSystem() {
+    // Until the workers are started, everything runs on the main thread's queue
+    queues.push_back(std::make_unique<Queue>());
+}
+
+JobSystem::~JobSystem() {
+    stop();
+}
+
+void JobSystem::start(int thread_count) {
+    stop();
+    if (thread_count < 0) {
+        // Leave one hardware thread for the main thread
+        int hardware_threads = std::thread::hardware_concurrency();
+        thread_count = std::max(hardware_threads - 1, 0);
+    }
+    queues.clear();
+    for (int i = 0; i < thread_count + 1; i++) {
+        queues.push_back(std::make_unique<Queue>());
+    }
+    running = true;
+    for (int i = 0; i < thread_count; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+    std::cout << "JobSystem::" << __func__ << "(): Started " << thread_count << " worker threads" << std::endl;
+}
+
+void JobSystem::stop() {
+    running = false;
+    wake(true);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+    // Finish anything the workers didn't get to
+    while (runNextJob(queues.size() - 1)) {}
+}
+
+void JobSystem::schedule(Job job, JobCounter *counter, const char *name, const JobCounter *dependency) {
+    if (counter != nullptr) {
+        counter->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    push(getQueueIndex(), QueuedJob{std::move(job), counter, name, dependency});
+}
+
+void JobSystem::wait(const JobCounter &counter) {
+    std::size_t queue_index = getQueueIndex();
+    while (!counter.isDone()) {
+        // Help out rather than just sitting there
+        if (!runNextJob(queue_index)) {
+            std::this_thread::yield();
+        }
+    }
+    // Every job is done, so nothing writes the exception anymore
+    if (counter.failed.load(std::memory_order_acquire)) {
+        std::rethrow_exception(counter.exception);
+    }
+}
+
+void JobSystem::parallelFor(std::size_t begin, std::size_t end, std::size_t batch_size,
+                            const std::function<void(std::size_t, std::size_t)> &body, const char *name) {
+    if (end <= begin) {
+        return;
+    }
+    batch_size = std::max(batch_size, (std::size_t) 1);
+    // Not worth the overhead of scheduling
+    if (workers.empty() || end - begin <= batch_size) {
+        body(begin, end);
+        return;
+    }
+    JobCounter counter;
+    for (std::size_t batch_begin = begin; batch_begin < end; batch_begin += batch_size) {
+        std::size_t batch_end = std::min(batch_begin + batch_size, end);
+        schedule([&body, batch_begin, batch_end]() { body(batch_begin, batch_end); }, &counter, name);
+    }
+    wait(counter);
+}
+
+void JobSystem::setTimingHook(TimingHook hook) {
+    std::lock_guard<std::mutex> lock(hook_mutex);
+    timing_hook = std::move(hook);
+    has_timing_hook = (bool) timing_hook;
+}
+
+void JobSystem::workerLoop(std::size_t index) {
+    worker_index = index;
+    while (true) {
+        // Read before looking for a job, so a job pushed (or unblocked) in between isn't missed
+        std::size_t generation = wake_generation.load();
+        if (runNextJob(index)) {
+            continue;
+        }
+        // Whatever is left is finished by stop()
+        if (!running) {
+            return;
+        }
+        // Either nothing is queued, or only jobs that are waiting for their dependencies
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        sleep_condition.wait(lock, [this, generation]() { return wake_generation.load() != generation || !running; });
+    }
+}
+
+std::size_t JobSystem::getQueueIndex() const {
+    if (worker_index < workers.size()) {
+        return worker_index;
+    }
+    // Every other thread shares the last queue
+    return queues.size() - 1;
+}
+
+void JobSystem::push(std::size_t queue_index, QueuedJob job) {
+    Queue &queue = *queues[queue_index];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    queued_jobs++;
+    wake(false);
+}
+
+void JobSystem::wake(bool all) {
+    {
+        // Makes sure a worker that's about to sleep sees the change
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake_generation++;
+    }
+    if (all) {
+        sleep_condition.notify_all();
+    } else {
+        sleep_condition.notify_one();
+    }
+}
+
+bool JobSystem::runNextJob(std::size_t queue_index) {
+    QueuedJob job;
+    bool found = tryTake(*queues[queue_index], true, job);
+    // Steal from the other queues, starting with our neighbour
+    for (std::size_t i = 1; !found && i < queues.size(); i++) {
+        found = tryTake(*queues[(queue_index + i) % queues.size()], false, job);
+    }
+    if (!found) {
+        return false;
+    }
+    queued_jobs--;
+    run(job, queue_index);
+    return true;
+}
+
+bool JobSystem::tryTake(Queue &queue, bool from_back, QueuedJob &job) {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    auto is_ready = [](const QueuedJob &queued_job) {
+        return queued_job.dependency == nullptr || queued_job.dependency->isDone();
+    };
+    if (from_back) {
+        auto it = std::find_if(queue.jobs.rbegin(), queue.jobs.rend(), is_ready);
+        if (it == queue.jobs.rend()) {
+            return false;
+        }
+        job = std::move(*it);
+        queue.jobs.erase(std::next(it).base());
+    } else {
+        auto it = std::find_if(queue.jobs.begin(), queue.jobs.end(), is_ready);
+        if (it == queue.jobs.end()) {
+            return false;
+        }
+        job = std::move(*it);
+        queue.jobs.erase(it);
+    }
+    return true;
+}
+
+void JobSystem::run(QueuedJob &job, std::size_t queue_index) {
+    // A job that throws still has to count as done, or whoever waits on it waits forever
+    auto run_job = [&job]() {
+        try {
+            job.job();
+        } catch (...) {
+            if (job.counter == nullptr) {
+                std::cout << "JobSystem::run(): Job " << (job.name != nullptr ? job.name : "(unnamed)") << " threw an exception" << std::endl;
+            } else if (!job.counter->failed.exchange(true, std::memory_order_relaxed)) {
+                job.counter->exception = std::current_exception();
+            }
+        }
+    };
+    if (has_timing_hook) {
+        auto start = std::chrono::steady_clock::now();
+        run_job();
+        auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+        TimingHook hook;
+        {
+            std::lock_guard<std::mutex> lock(hook_mutex);
+            hook = timing_hook;
+        }
+        if (hook) {
+            hook(job.name, duration, queue_index);
+        }
+    } else {
+        run_job();
+    }
+    // The last job of a group might unblock jobs that depend on it
+    if (job.counter != nullptr && job.counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        wake(true);
+    }
+}
+
+} // namespace engine
+} // namespace rpg
@@ -6,10 +6,15 @@ namespace rpg {
 namespace engine {
 
 MobileObject::MobileObject(const sf::Vector2f &position, const resources::GameRegistry::ObjectData &data)
-    : GameObject(position, data) {}
+    : GameObject(position, data), previous_position(position) {}
 
 void MobileObject::update(float dt) {
+    previous_position = position;
     sf::Vector2f offset = direction * speed * dt;
+    // Stop at solid tiles and static objects
+    if (chunk_map != nullptr) {
+        offset = chunk_map->slide(aabb, offset);
+    }
     move(offset);
 }
 
@@ -29,6 +34,14 @@ void MobileObject::resolveCollision(const AABB &other) {
     move({penetration_depth.x * collision_normal.x, penetration_depth.y * collision_normal.y});
 }
 
+void MobileObject::resolveCollision(MobileObject &other) {
+    sf::Vector2f penetration_depth, collision_normal;
+    aabb.resolveCollision(other.getAABB(), penetration_depth, collision_normal);
+    sf::Vector2f offset(penetration_depth.x * collision_normal.x, penetration_depth.y * collision_normal.y);
+    move(offset / 2.0f);
+    other.move(-offset / 2.0f);
+}
+
 void MobileObject::setDirection(const sf::Vector2f &direction) {
     double magnitude = sqrt(direction.x * direction.x + direction.y * direction.y);
     if (magnitude != 0) {
@@ -43,5 +56,10 @@ bool MobileObject::isMoving() const {
     return direction.x != 0 || direction.y != 0;
 }
 
+sf::Vector2f MobileObject::getInterpolationOffset(float alpha) const {
+    // We're drawing somewhere between the previous and the current position
+    return (previous_position - position) * (1.0f - alpha);
+}
+
 } // namespace engine
 } // namespace rpg
\ No newline at end of file
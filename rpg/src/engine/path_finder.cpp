@@ -0,0 +1,308 @@
+#include "engine/path_finder.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @brief The directions an agent can move in.
+*/
+static const sf::Vector2i DIRECTIONS[4] = {
+    sf::Vector2i(1, 0), sf::Vector2i(-1, 0), sf::Vector2i(0, 1), sf::Vector2i(0, -1)
+};
+
+PathFinder::PathFinder(const ChunkMap &chunk_map) : chunk_map(chunk_map) {
+    chunk_dimensions = chunk_map.getChunkDimensions();
+    graphs.resize(chunk_dimensions.x * chunk_dimensions.y);
+}
+
+bool PathFinder::findPath(const sf::Vector2i &start, const sf::Vector2i &goal, std::vector<sf::Vector2i> &path) {
+    path.clear();
+    if (chunk_map.isSolid(start.x, start.y) || chunk_map.isSolid(goal.x, goal.y)) {
+        return false;
+    }
+    int start_chunk = getChunkIndex(start);
+    int goal_chunk = getChunkIndex(goal);
+    auto build = [this](int chunk_index) {
+        if (graphs[chunk_index].dirty) {
+            buildChunk(chunk_index);
+        }
+    };
+    build(start_chunk);
+    build(goal_chunk);
+    // If the goal can be reached without leaving the chunk, there's no need for the abstract search
+    search(start_chunk, getLocalIndex(start), start_parents, start_distances);
+    if (start_chunk == goal_chunk && start_distances[getLocalIndex(goal)] != NONE) {
+        path.push_back(start);
+        appendPath(start_chunk, getLocalIndex(goal), start_parents, path);
+        return true;
+    }
+    search(goal_chunk, getLocalIndex(goal), goal_parents, goal_distances);
+    // A* over the nodes, with the start and the goal as two extra nodes
+    const uint32_t START = 0xFFFFFFFE;
+    const uint32_t GOAL = 0xFFFFFFFF;
+    std::priority_queue<SearchNode, std::vector<SearchNode>, std::greater<SearchNode>> open;
+    std::unordered_map<uint32_t, uint32_t> costs;
+    std::unordered_map<uint32_t, uint32_t> came_from;
+    auto estimate = [&goal](const sf::Vector2i &tile) -> uint32_t {
+        return std::abs(tile.x - goal.x) + std::abs(tile.y - goal.y);
+    };
+    auto visit = [&](uint32_t from, uint32_t to, uint32_t cost, const sf::Vector2i &tile) {
+        auto it = costs.find(to);
+        if (it != costs.end() && it->second <= cost) {
+            return;
+        }
+        costs[to] = cost;
+        came_from[to] = from;
+        open.push({to, cost, cost + estimate(tile)});
+    };
+    costs[START] = 0;
+    open.push({START, 0, estimate(start)});
+    bool found = false;
+    while (!open.empty()) {
+        SearchNode current = open.top();
+        open.pop();
+        if (current.cost > costs[current.id]) {
+            // We've already found a cheaper way here
+            continue;
+        }
+        if (current.id == GOAL) {
+            found = true;
+            break;
+        }
+        if (current.id == START) {
+            const ChunkGraph &graph = graphs[start_chunk];
+            for (uint16_t i = 0; i < graph.nodes.size(); i++) {
+                uint16_t distance = start_distances[graph.nodes[i]];
+                if (distance != NONE) {
+                    visit(START, getNodeId(start_chunk, i), distance, getTile(start_chunk, graph.nodes[i]));
+                }
+            }
+            continue;
+        }
+        int chunk_index = current.id >> 16;
+        uint16_t node = current.id & 0xFFFF;
+        const ChunkGraph &graph = graphs[chunk_index];
+        std::size_t node_count = graph.nodes.size();
+        sf::Vector2i tile = getTile(chunk_index, graph.nodes[node]);
+        if (chunk_index == goal_chunk && goal_distances[graph.nodes[node]] != NONE) {
+            visit(current.id, GOAL, current.cost + goal_distances[graph.nodes[node]], goal);
+        }
+        // The other nodes in the same chunk
+        for (uint16_t other = 0; other < node_count; other++) {
+            uint16_t distance = graph.distances[node * node_count + other];
+            if (other != node && distance != NONE) {
+                visit(current.id, getNodeId(chunk_index, other), current.cost + distance, getTile(chunk_index, graph.nodes[other]));
+            }
+        }
+        // The node on the other side of the border
+        for (const sf::Vector2i &direction : DIRECTIONS) {
+            sf::Vector2i neighbour = tile + direction;
+            int neighbour_chunk = getChunkIndex(neighbour);
+            if (neighbour_chunk == -1 || neighbour_chunk == chunk_index || chunk_map.isSolid(neighbour.x, neighbour.y)) {
+                continue;
+            }
+            build(neighbour_chunk);
+            uint16_t neighbour_node = graphs[neighbour_chunk].node_at[getLocalIndex(neighbour)];
+            if (neighbour_node != NONE) {
+                visit(current.id, getNodeId(neighbour_chunk, neighbour_node), current.cost + 1, neighbour);
+            }
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    // Walk back from the goal to get the nodes along the path
+    std::vector<uint32_t> nodes;
+    for (uint32_t id = came_from[GOAL]; id != START; id = came_from[id]) {
+        nodes.push_back(id);
+    }
+    std::reverse(nodes.begin(), nodes.end());
+    // Turn the nodes back into tiles
+    path.push_back(start);
+    int first_chunk = nodes.front() >> 16;
+    appendPath(first_chunk, graphs[first_chunk].nodes[nodes.front() & 0xFFFF], start_parents, path);
+    for (std::size_t i = 1; i < nodes.size(); i++) {
+        int from_chunk = nodes[i - 1] >> 16;
+        int to_chunk = nodes[i] >> 16;
+        uint16_t to_node = nodes[i] & 0xFFFF;
+        if (from_chunk == to_chunk) {
+            const std::vector<sf::Vector2i> &segment = getPath(from_chunk, nodes[i - 1] & 0xFFFF, to_node);
+            path.insert(path.end(), segment.begin(), segment.end());
+        } else {
+            // Crossing the border is a single step
+            path.push_back(getTile(to_chunk, graphs[to_chunk].nodes[to_node]));
+        }
+    }
+    // The search from the goal leads from the last node to the goal
+    uint16_t local = graphs[goal_chunk].nodes[nodes.back() & 0xFFFF];
+    uint16_t goal_local = getLocalIndex(goal);
+    while (local != goal_local) {
+        local = goal_parents[local];
+        path.push_back(getTile(goal_chunk, local));
+    }
+    return true;
+}
+
+void PathFinder::invalidateTile(int x, int y) {
+    int chunk_index = getChunkIndex(sf::Vector2i(x, y));
+    if (chunk_index == -1) {
+        return;
+    }
+    graphs[chunk_index].dirty = true;
+    // Tiles along a border also decide the entrances of the chunk on the other side
+    for (const sf::Vector2i &direction : DIRECTIONS) {
+        int neighbour_chunk = getChunkIndex(sf::Vector2i(x, y) + direction);
+        if (neighbour_chunk != -1) {
+            graphs[neighbour_chunk].dirty = true;
+        }
+    }
+}
+
+std::size_t PathFinder::getNodeCount() const {
+    std::size_t count = 0;
+    for (const ChunkGraph &graph : graphs) {
+        if (!graph.dirty) {
+            count += graph.nodes.size();
+        }
+    }
+    return count;
+}
+
+void PathFinder::buildChunk(int chunk_index) {
+    ChunkGraph &graph = graphs[chunk_index];
+    graph.nodes.clear();
+    graph.node_at.assign(CHUNK_TILES, NONE);
+    for (const sf::Vector2i &direction : DIRECTIONS) {
+        addEntrances(chunk_index, direction, graph);
+    }
+    // Precompute the distances between all nodes in the chunk
+    std::size_t node_count = graph.nodes.size();
+    graph.distances.assign(node_count * node_count, NONE);
+    graph.parents.resize(node_count);
+    graph.paths.assign(node_count * node_count, std::vector<sf::Vector2i>());
+    std::vector<uint16_t> distances;
+    for (std::size_t from = 0; from < node_count; from++) {
+        search(chunk_index, graph.nodes[from], graph.parents[from], distances);
+        for (std::size_t to = 0; to < node_count; to++) {
+            graph.distances[from * node_count + to] = distances[graph.nodes[to]];
+        }
+    }
+    graph.dirty = false;
+}
+
+void PathFinder::addEntrances(int chunk_index, const sf::Vector2i &direction, ChunkGraph &graph) const {
+    sf::Vector2i origin = getTile(chunk_index, 0);
+    // The tiles along the border, and the axis to walk along it
+    sf::Vector2i first = origin;
+    if (direction.x > 0) {
+        first.x += constants::CHUNK_SIZE - 1;
+    } else if (direction.y > 0) {
+        first.y += constants::CHUNK_SIZE - 1;
+    }
+    sf::Vector2i step = (direction.x != 0) ? sf::Vector2i(0, 1) : sf::Vector2i(1, 0);
+    auto add_node = [&](int i) {
+        uint16_t local = getLocalIndex(first + step * i);
+        if (graph.node_at[local] == NONE) {
+            graph.node_at[local] = graph.nodes.size();
+            graph.nodes.push_back(local);
+        }
+    };
+    /**
+    An entrance is a run of tiles that are walkable on both sides of the border.
+    Both chunks find the same runs, and place their nodes opposite each other.
+    */
+    int run_start = -1;
+    for (int i = 0; i <= constants::CHUNK_SIZE; i++) {
+        bool walkable = false;
+        if (i < constants::CHUNK_SIZE) {
+            sf::Vector2i inside = first + step * i;
+            sf::Vector2i outside = inside + direction;
+            walkable = !chunk_map.isSolid(inside.x, inside.y) && !chunk_map.isSolid(outside.x, outside.y);
+        }
+        if (walkable && run_start == -1) {
+            run_start = i;
+        } else if (!walkable && run_start != -1) {
+            int run_end = i - 1;
+            if (run_end - run_start + 1 >= LONG_ENTRANCE_LENGTH) {
+                add_node(run_start);
+                add_node(run_end);
+            } else {
+                add_node((run_start + run_end) / 2);
+            }
+            run_start = -1;
+        }
+    }
+}
+
+void PathFinder::search(int chunk_index, uint16_t source, std::vector<uint16_t> &parents, std::vector<uint16_t> &distances) const {
+    parents.assign(CHUNK_TILES, NONE);
+    distances.assign(CHUNK_TILES, NONE);
+    sf::Vector2i origin = getTile(chunk_index, 0);
+    // Every tile is queued at most once, so a fixed size queue is enough
+    uint16_t queue[CHUNK_TILES];
+    int head = 0;
+    int tail = 0;
+    queue[tail++] = source;
+    parents[source] = source;
+    distances[source] = 0;
+    while (head < tail) {
+        uint16_t current = queue[head++];
+        int x = current % constants::CHUNK_SIZE;
+        int y = current / constants::CHUNK_SIZE;
+        for (const sf::Vector2i &direction : DIRECTIONS) {
+            int next_x = x + direction.x;
+            int next_y = y + direction.y;
+            if (next_x < 0 || next_x >= constants::CHUNK_SIZE || next_y < 0 || next_y >= constants::CHUNK_SIZE) {
+                continue;
+            }
+            uint16_t next = next_x + next_y * constants::CHUNK_SIZE;
+            if (parents[next] != NONE || chunk_map.isSolid(origin.x + next_x, origin.y + next_y)) {
+                continue;
+            }
+            parents[next] = current;
+            distances[next] = distances[current] + 1;
+            queue[tail++] = next;
+        }
+    }
+}
+
+void PathFinder::appendPath(int chunk_index, uint16_t target, const std::vector<uint16_t> &parents, std::vector<sf::Vector2i> &path) const {
+    std::size_t first = path.size();
+    for (uint16_t local = target; parents[local] != local; local = parents[local]) {
+        path.push_back(getTile(chunk_index, local));
+    }
+    // We walked from the target to the source
+    std::reverse(path.begin() + first, path.end());
+}
+
+const std::vector<sf::Vector2i>& PathFinder::getPath(int chunk_index, uint16_t from, uint16_t to) {
+    ChunkGraph &graph = graphs[chunk_index];
+    std::vector<sf::Vector2i> &path = graph.paths[from * graph.nodes.size() + to];
+    if (path.empty() && from != to) {
+        appendPath(chunk_index, graph.nodes[to], graph.parents[from], path);
+    }
+    return path;
+}
+
+int PathFinder::getChunkIndex(const sf::Vector2i &tile) const {
+    const sf::Vector2i &dimensions = chunk_map.getDimensions();
+    if (tile.x < 0 || tile.x >= dimensions.x || tile.y < 0 || tile.y >= dimensions.y) {
+        return -1;
+    }
+    return tile.x / constants::CHUNK_SIZE + (tile.y / constants::CHUNK_SIZE) * chunk_dimensions.x;
+}
+
+sf::Vector2i PathFinder::getTile(int chunk_index, uint16_t local_index) const {
+    return sf::Vector2i(
+        (chunk_index % chunk_dimensions.x) * constants::CHUNK_SIZE + local_index % constants::CHUNK_SIZE,
+        (chunk_index / chunk_dimensions.x) * constants::CHUNK_SIZE + local_index / constants::CHUNK_SIZE);
+}
+
+} // namespace engine
+} // namespace rpg
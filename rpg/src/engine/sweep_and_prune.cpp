@@ -0,0 +1,93 @@
+#include "engine/sweep_and_prune.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace rpg {
+namespace engine {
+
+void SweepAndPrune::insert(MobileObject *object) {
+    if (proxy_ids.find(object) != proxy_ids.end()) {
+        return;
+    }
+    uint32_t proxy;
+    if (!free_proxies.empty()) {
+        proxy = free_proxies.back();
+        free_proxies.pop_back();
+        proxies[proxy] = object;
+    } else {
+        proxy = proxies.size();
+        proxies.push_back(object);
+    }
+    proxy_ids[object] = proxy;
+    /**
+    The new endpoints start out at the very end of the list, where they don't
+    overlap anything. The next update moves them into place, and the swaps
+    on the way there add the pairs of the new object.
+    */
+    float infinity = std::numeric_limits<float>::infinity();
+    endpoints.push_back({infinity, proxy, true});
+    endpoints.push_back({infinity, proxy, false});
+}
+
+void SweepAndPrune::remove(MobileObject *object) {
+    auto it = proxy_ids.find(object);
+    if (it == proxy_ids.end()) {
+        return;
+    }
+    uint32_t proxy = it->second;
+    proxy_ids.erase(it);
+    proxies[proxy] = nullptr;
+    free_proxies.push_back(proxy);
+    // Removing preserves the order of the remaining endpoints
+    endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [proxy](const Endpoint &endpoint) {
+        return endpoint.proxy == proxy;
+    }), endpoints.end());
+    for (auto pair_it = pairs.begin(); pair_it != pairs.end();) {
+        if ((*pair_it >> 32) == proxy || (*pair_it & 0xFFFFFFFF) == proxy) {
+            pair_it = pairs.erase(pair_it);
+        } else {
+            ++pair_it;
+        }
+    }
+}
+
+void SweepAndPrune::update() {
+    for (Endpoint &endpoint : endpoints) {
+        endpoint.value = getValue(endpoint);
+    }
+    // Insertion sort, which is close to linear since the list is almost sorted
+    for (std::size_t i = 1; i < endpoints.size(); i++) {
+        Endpoint endpoint = endpoints[i];
+        std::size_t j = i;
+        while (j > 0 && endpoints[j - 1].value > endpoint.value) {
+            const Endpoint &other = endpoints[j - 1];
+            if (endpoint.is_min && !other.is_min) {
+                // We now start before the other object ends, so we overlap
+                pairs.insert(getPairKey(endpoint.proxy, other.proxy));
+            } else if (!endpoint.is_min && other.is_min) {
+                // We now end before the other object starts, so we don't overlap
+                pairs.erase(getPairKey(endpoint.proxy, other.proxy));
+            }
+            endpoints[j] = other;
+            j--;
+        }
+        endpoints[j] = endpoint;
+    }
+}
+
+void SweepAndPrune::getPairs(std::vector<Pair> &pairs) const {
+    pairs.clear();
+    pairs.reserve(this->pairs.size());
+    for (uint64_t key : this->pairs) {
+        pairs.emplace_back(proxies[key >> 32], proxies[key & 0xFFFFFFFF]);
+    }
+}
+
+float SweepAndPrune::getValue(const Endpoint &endpoint) const {
+    const AABB &aabb = proxies[endpoint.proxy]->getAABB();
+    return endpoint.is_min ? aabb.left : aabb.left + aabb.width;
+}
+
+} // namespace engine
+} // namespace rpg
@@ -11,18 +11,20 @@ namespace engine {
 Tile::Tile(const sf::Vector2f &position, const resources::GameRegistry::TileData &data) {
     this->registry_name = data.registry_name;
     this->position = position;
+    this->texture_id = data.texture_id;
     // TODO: This is a bit of a hack, but it works for now
     resources::ResourceManager& resource_manager = resources::GameRegistry::getInstance().getResourceManager();
-    this->vertex_quad = resource_manager.getVertexQuad(this->registry_name);
+    this->vertex_quad = resource_manager.getVertexQuad(data.texture_id);
     this->vertex_quad.setPosition(position);
     // Check if the tile has any variations
-    if (resource_manager.hasVariations(this->registry_name)) {
-        this->variations = resource_manager.getVariations(this->registry_name);
-        this->vertex_quad.setTextureRect(this->variations->getRandomRect());
+    if (resource_manager.hasVariations(data.texture_id)) {
+        this->variations = resource_manager.getVariations(data.texture_id);
+        this->variation = this->variations->getRandomIndex();
+        this->vertex_quad.setTextureRect(this->variations->getRect(this->variation));
     }
     // Check if the tile has any connected textures
-    if (resource_manager.hasConnectedTexture(this->registry_name)) {
-        this->connected_texture = resource_manager.getConnectedTexture(this->registry_name);
+    if (resource_manager.hasConnectedTexture(data.connected_texture_id)) {
+        this->connected_texture = resource_manager.getConnectedTexture(data.connected_texture_id);
     }
 }
 
@@ -32,7 +34,7 @@ Tile::Tile() {
     Tile(sf::Vector2f(0.0f, 0.0f), data);
 }
 
-const std::vector<sf::Vertex>& Tile::getVertices() const {
+const resources::VertexQuad::Vertices& Tile::getVertices() const {
     return vertex_quad.getVertices();
 }
 
@@ -41,6 +43,8 @@ void Tile::connectTexture(resources::connected_textures::ConnectedTexture::Neigh
     if (connected_texture == nullptr) {
         return;
     }
+    this->neighbours = neighbours;
+    connected = true;
     // Check if the tile has all neighbours
     // if (neighbours == connected_texture->getAllNeighbours()) {
     //     // If the has variations, use a random variation instead
@@ -52,6 +56,21 @@ void Tile::connectTexture(resources::connected_textures::ConnectedTexture::Neigh
     // this->sprite.setTextureRect(connected_texture->getRect(neighbours));
     // TODO: Move the texture coordinates of the vertices to the correct position
     vertex_quad.setTextureRect(connected_texture->getRect(neighbours));
+    vertex_quad.setPage(connected_texture->getPage());
+}
+
+void Tile::refreshTexture() {
+    resources::ResourceManager& resource_manager = resources::GameRegistry::getInstance().getResourceManager();
+    // Mobile objects have moved since they were created, so keep the quad where it is
+    sf::Vector2f quad_position = vertex_quad.getPosition();
+    vertex_quad = resource_manager.getVertexQuad(texture_id);
+    vertex_quad.setPosition(quad_position);
+    if (variations != nullptr) {
+        vertex_quad.setTextureRect(variations->getRect(variation));
+    }
+    if (connected) {
+        connectTexture(neighbours);
+    }
 }
 
 } // namespace engine
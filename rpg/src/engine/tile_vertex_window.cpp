@@ -0,0 +1,106 @@
+#include "engine/tile_vertex_window.hpp"
+#include "resources/game_registry.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace rpg {
+namespace engine {
+
+/**
+ * @brief Modulo that is always positive, so negative tile coordinates
+ * wrap around the window the same way as positive ones.
+*/
+static inline int wrap(int value, int size) {
+    int result = value % size;
+    return result < 0 ? result + size : result;
+}
+
+void TileVertexWindow::update(const sf::View &view, const TileGetter &get_tile) {
+    sf::Vector2f view_size = view.getSize();
+    sf::Vector2f view_top_left = view.getCenter() - view_size / 2.0f;
+    // +1 since the view can partially cover one extra tile in each direction
+    sf::Vector2i new_size((int) std::ceil(view_size.x) + 1, (int) std::ceil(view_size.y) + 1);
+    sf::Vector2i new_origin((int) std::floor(view_top_left.x), (int) std::floor(view_top_left.y));
+    // The whole window has to be rebuilt if the size changed, or if we moved so
+    // far that none of the old tiles are visible anymore
+    if (dirty || new_size != size ||
+        std::abs(new_origin.x - origin.x) >= size.x ||
+        std::abs(new_origin.y - origin.y) >= size.y) {
+        size = new_size;
+        origin = new_origin;
+        pages.resize(std::max<std::size_t>(pages.size(), 1));
+        for (std::vector<sf::Vertex> &vertices : pages) {
+            vertices.assign(size.x * size.y * 4, sf::Vertex());
+        }
+        buildRect(origin.x, origin.y, origin.x + size.x, origin.y + size.y, get_tile);
+        dirty = false;
+        return;
+    }
+    if (new_origin == origin) {
+        return;
+    }
+    sf::Vector2i old_origin = origin;
+    origin = new_origin;
+    int x_end = origin.x + size.x;
+    int y_end = origin.y + size.y;
+    // Rebuild the columns that were scrolled into view
+    if (origin.x > old_origin.x) {
+        buildRect(old_origin.x + size.x, origin.y, x_end, y_end, get_tile);
+    } else if (origin.x < old_origin.x) {
+        buildRect(origin.x, origin.y, old_origin.x, y_end, get_tile);
+    }
+    // Rebuild the rows that were scrolled into view
+    if (origin.y > old_origin.y) {
+        buildRect(origin.x, old_origin.y + size.y, x_end, y_end, get_tile);
+    } else if (origin.y < old_origin.y) {
+        buildRect(origin.x, origin.y, x_end, old_origin.y, get_tile);
+    }
+}
+
+void TileVertexWindow::draw(sf::RenderTarget &target, sf::RenderStates states) const {
+    resources::GameRegistry &game_registry = resources::GameRegistry::getInstance();
+    for (uint32_t page = 0; page < pages.size(); page++) {
+        if (pages[page].empty()) {
+            continue;
+        }
+        states.texture = &game_registry.getTextureAtlas(page);
+        target.draw(pages[page].data(), pages[page].size(), sf::Quads, states);
+    }
+}
+
+void TileVertexWindow::buildTile(int x, int y, const TileGetter &get_tile) {
+    int slot = (wrap(x, size.x) + wrap(y, size.y) * size.x) * 4;
+    const Tile* tile = get_tile(x, y);
+    // Collapse the quad on every page, so it's only drawn on the page of the tile (if any)
+    for (std::vector<sf::Vertex> &vertices : pages) {
+        for (int i = 0; i < 4; i++) {
+            vertices[slot + i] = sf::Vertex();
+        }
+    }
+    if (tile == nullptr) {
+        // Outside the world, so nothing is drawn
+        return;
+    }
+    uint32_t page = tile->getPage();
+    if (page >= pages.size()) {
+        pages.resize(page + 1, std::vector<sf::Vertex>(size.x * size.y * 4, sf::Vertex()));
+    }
+    const resources::VertexQuad::Vertices &tile_vertices = tile->getVertices();
+    for (int i = 0; i < 4; i++) {
+        pages[page][slot + i] = tile_vertices[i];
+    }
+}
+
+void TileVertexWindow::buildRect(int x_start, int y_start, int x_end, int y_end, const TileGetter &get_tile) {
+    // Row by row, since both the tiles and the window are stored row-major
+    for (int y = y_start; y < y_end; y++) {
+        for (int x = x_start; x < x_end; x++) {
+            buildTile(x, y, get_tile);
+        }
+    }
+}
+
+} // namespace engine
+} // namespace rpg
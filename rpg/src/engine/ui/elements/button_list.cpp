@@ -66,6 +66,13 @@ void ButtonList::update(float delta_time) {
     }
 }
 
+void ButtonList::refreshTextures() {
+    UIElement::refreshTextures();
+    for (auto &button : buttons) {
+        button->refreshTextures();
+    }
+}
+
 void ButtonList::draw(sf::RenderTarget &target, sf::RenderStates states) const {
     UIElement::draw(target, states);
     for (auto &button : buttons) {
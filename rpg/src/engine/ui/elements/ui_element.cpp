@@ -9,6 +9,10 @@ UIElement::UIElement(const std::string &registry_name, const std::string &label,
     this->registry_name = registry_name;
     this->label = label;
     this->on_click = on_click;
+    resources::ResourceManager &resource_manager = resources::GameRegistry::getInstance().getResourceManager();
+    connected_texture_ids[static_cast<int>(State::DEFAULT)] = resource_manager.getConnectedTextureId(registry_name);
+    connected_texture_ids[static_cast<int>(State::HOVERED)] = resource_manager.getConnectedTextureId(registry_name + "_hovered");
+    connected_texture_ids[static_cast<int>(State::CLICKED)] = resource_manager.getConnectedTextureId(registry_name + "_clicked");
     createSpriteGrid(rect);
 }
 
@@ -52,22 +56,19 @@ void UIElement::update(float delta_time) {
     }
     // Update the state and the sprites
     state = next_state;
+    UIElement::refreshTextures();
+}
+
+void UIElement::refreshTextures() {
     resources::ResourceManager &resource_manager = resources::GameRegistry::getInstance().getResourceManager();
-    std::string texture_key;
-    switch (state) {
-        case State::DEFAULT:
-            texture_key = registry_name;
-            break;
-        case State::HOVERED:
-            texture_key = registry_name + "_hovered";
-            break;
-        case State::CLICKED:
-            texture_key = registry_name + "_clicked";
-            break;
+    resources::TextureId connected_texture_id = connected_texture_ids[static_cast<int>(state)];
+    if (!resource_manager.hasConnectedTexture(connected_texture_id)) {
+        throw std::runtime_error("UIElement::" + std::string(__func__) + "(): Connected texture not loaded: " + registry_name);
     }
-    connected_texture = resource_manager.getConnectedTexture(texture_key);
+    connected_texture = resource_manager.getConnectedTexture(connected_texture_id);
     for (int i = 0; i < vertex_quad_grid.size(); i++) {
         vertex_quad_grid[i].setTextureRect(connected_texture->getRect(neighbour_grid[i]));
+        vertex_quad_grid[i].setPage(connected_texture->getPage());
     }
 }
 
@@ -90,13 +91,22 @@ void UIElement::draw(sf::RenderTarget &target, sf::RenderStates states) const {
     // for (auto &sprite : sprite_grid) {
     //     target.draw(sprite, states);
     // }
-    states.texture = &resources::GameRegistry::getInstance().getResourceManager().getTextureAtlas();
+    const resources::ResourceManager &resource_manager = resources::GameRegistry::getInstance().getResourceManager();
     std::vector<sf::Vertex> vertices;
     vertices.reserve(4 * vertex_quad_grid.size());
+    // A new draw call is only needed when the next quad is on another page of the texture atlas
+    uint32_t page = vertex_quad_grid.empty() ? 0 : vertex_quad_grid.front().getPage();
     for (auto &vertex_quad : vertex_quad_grid) {
-        std::vector<sf::Vertex> vertex_quad_vertices = vertex_quad.getVertices();
+        if (vertex_quad.getPage() != page) {
+            states.texture = &resource_manager.getTextureAtlas(page);
+            target.draw(vertices.data(), vertices.size(), sf::Quads, states);
+            vertices.clear();
+            page = vertex_quad.getPage();
+        }
+        resources::VertexQuad::Vertices vertex_quad_vertices = vertex_quad.getVertices();
         vertices.insert(vertices.end(), vertex_quad_vertices.begin(), vertex_quad_vertices.end());
     }
+    states.texture = &resource_manager.getTextureAtlas(page);
     target.draw(vertices.data(), vertices.size(), sf::Quads, states);
 }
 
@@ -127,12 +137,17 @@ void UIElement::createSpriteGrid(const sf::IntRect &rect) {
     neighbour_grid.clear();
     neighbour_grid.reserve(size.x * size.y);
     resources::ResourceManager &resource_manager = resources::GameRegistry::getInstance().getResourceManager();
-    connected_texture = resource_manager.getConnectedTexture(registry_name);
+    resources::TextureId connected_texture_id = connected_texture_ids[static_cast<int>(State::DEFAULT)];
+    if (!resource_manager.hasConnectedTexture(connected_texture_id)) {
+        throw std::runtime_error("UIElement::" + std::string(__func__) + "(): Connected texture not loaded: " + registry_name);
+    }
+    connected_texture = resource_manager.getConnectedTexture(connected_texture_id);
+    const resources::VertexQuad &connected_vertex_quad = resource_manager.getVertexQuad(connected_texture_id);
     for (int y = 0; y < size.y; y++) {
         for (int x = 0; x < size.x; x++) {
             // Find the neighbours of the current sprite
             resources::connected_textures::ConnectedTexture::Neighbours neighbours = getNeighbours(x, y, size);
-            resources::VertexQuad vertex_quad = resource_manager.getVertexQuad(registry_name + "_connected");
+            resources::VertexQuad vertex_quad = connected_vertex_quad;
             vertex_quad.setTextureRect(connected_texture->getRect(neighbours));
             vertex_quad.setPosition(sf::Vector2f(rect.left + x, rect.top + y));
             // sf::Sprite sprite = resource_manager.getSprite(registry_name + "_connected");
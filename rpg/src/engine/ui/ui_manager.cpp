@@ -37,6 +37,12 @@ sf::Vector2f UIManager::getMousePos() const {
     return window->mapPixelToCoords(sf::Mouse::getPosition(*window));
 }
 
+void UIManager::refreshTextures() {
+    for (auto &element : ui_elements) {
+        element->refreshTextures();
+    }
+}
+
 void UIManager::update(float delta_time) {
     for (auto &element : ui_elements) {
         element->update(delta_time);
@@ -1,7 +1,12 @@
 #include "engine/world.hpp"
 #include "engine/mobile_object.hpp"
+#include "engine/ecs/systems.hpp"
+#include "engine/constants.hpp"
 #include "FastNoiseLite.h"
 
+#include <cmath>
+#include <limits>
+
 namespace rpg {
 namespace engine {
 
@@ -11,7 +16,10 @@ World::World(const sf::Vector2i &dimensions, int seed)
     world_border{AABB(sf::Vector2f(0, 0), sf::Vector2f(dimensions.x, 0)), 
                  AABB(sf::Vector2f(0, 0), sf::Vector2f(0, dimensions.y)),
                  AABB(sf::Vector2f(0, dimensions.y), sf::Vector2f(dimensions.x, 0)), 
-                 AABB(sf::Vector2f(dimensions.x, 0), sf::Vector2f(0, dimensions.y))} {
+                 AABB(sf::Vector2f(dimensions.x, 0), sf::Vector2f(0, dimensions.y))},
+    chunk_map(dimensions),
+    path_finder(chunk_map),
+    flow_field(chunk_map, constants::FLOW_FIELD_RADIUS, constants::FLOW_FIELD_MAX_DRIFT) {
     this->seed = seed;
     // Allocate the tiles vector
     tiles.resize((dimensions.x + 1) * (dimensions.y + 1));
@@ -48,62 +56,146 @@ World::World(const sf::Vector2i &dimensions, int seed)
             }
         }
     }
+    chunk_map.bake();
+}
+
+void World::interpolate(float alpha) {
+    interpolation_alpha = alpha;
+    registry.getAnimationBatch().updatePositions(registry.getStore<ecs::Position>(), alpha);
 }
 
 void World::update(float delta) {
     last_delta = delta;
+    // Static objects added since the last tick
+    chunk_map.bake();
     player->update(delta);
-    for (auto &game_object : game_objects) {
-        // Check if the game object is a mobile object
-        MobileObject* mobile_object = static_cast<MobileObject*>(game_object.get());
-        if (mobile_object != nullptr) {
-            // Update the mobile object
-            mobile_object->update(delta);
-        }
-    }
-    // Check if the player is colliding with the world border
-    for (auto &border : world_border) {
-        if (player->isColliding(border)) {
-            // Resolve the collision
-            player->resolveCollision(border);
-        }
-    }
-    // Check if the player collided with any game objects
-    for (auto &game_object : game_objects) {
-        if (player->isColliding(*game_object.get())) {
-            // Resolve the collision
-            player->resolveCollision(*game_object.get());
+    mobile_objects.forEach([delta](MobileObject &mobile_object) {
+        mobile_object.update(delta);
+    });
+    // Keep the flow field centered on the player
+    const AABB &player_aabb = player->getAABB();
+    sf::Vector2f player_center(player_aabb.left + player_aabb.width / 2.0f, player_aabb.top + player_aabb.height / 2.0f);
+    flow_field.setGoal(sf::Vector2i((int) std::floor(player_center.x), (int) std::floor(player_center.y)));
+    flow_field.update(constants::FLOW_FIELD_TILES_PER_TICK);
+    // Entities far away from the player are updated less often
+    tick_scheduler.schedule(registry, player_center, delta);
+    const std::vector<ecs::ScheduledUpdate> &scheduled_updates = tick_scheduler.getUpdates();
+    ecs::followFlowField(registry, flow_field, scheduled_updates);
+    ecs::updateMovement(registry, &chunk_map, scheduled_updates);
+    ecs::updateAnimations(registry, animation_tables, game_registry.getResourceManager(), scheduled_updates);
+    // Animations are cheap enough to play every tick, whatever the level of detail
+    registry.getAnimationBatch().update(delta);
+    // Push apart the mobile objects that collided with each other
+    sweep_and_prune.update();
+    sweep_and_prune.getPairs(collision_pairs);
+    for (auto &[a, b] : collision_pairs) {
+        if (a->isColliding(*b)) {
+            a->resolveCollision(*b);
         }
     }
-    // Sort the drawables by y position so that they are drawn in the correct order
+    // Static objects can't be pushed, so they're resolved last
+    resolveCollisions(*player);
+    mobile_objects.forEach([this](MobileObject &mobile_object) {
+        resolveCollisions(mobile_object);
+    });
+    // Sort the mobile objects by y position so that they are drawn in the correct order
     std::sort(drawables.begin(), drawables.end(), [](GameObject* a, GameObject* b) -> bool {
         return a->getAABB().getPosition().y < b->getAABB().getPosition().y;
     });
 }
 
 void World::draw(sf::RenderTarget &target, sf::RenderStates states) const {
-    sf::VertexArray vertex_array(sf::PrimitiveType::Quads);
-    // Get the viewport of the view
-    sf::FloatRect viewport = getViewport(target.getView());
     // Draw the tiles as the background
-    for (const auto& tile : getVisibleTiles(viewport)) {
-        for (const auto& vertex : tile->getVertices()) {
-            vertex_array.append(vertex);
+    target.draw(tile_window, states);
+    sf::VertexArray &vertex_array = draw_vertices;
+    vertex_array.setPrimitiveType(sf::PrimitiveType::Quads);
+    vertex_array.clear();
+    /**
+    The objects have to be drawn in order, so the vertex array is only drawn
+    (and a new batch started) when the next quad is on another page of the
+    texture atlas than the quads before it. Usually everything is on the first
+    page, and this is a single draw call.
+    */
+    uint32_t batch_page = 0;
+    auto flush = [&]() {
+        if (vertex_array.getVertexCount() > 0) {
+            states.texture = &game_registry.getTextureAtlas(batch_page);
+            target.draw(vertex_array, states);
+            vertex_array.clear();
         }
-    }
-    // Draw the drawables
-    for (auto &drawable : drawables) {
-        // Check if the drawable is in the view
-        if (!viewport.intersects(drawable->getAABB())) {
-            continue;
+    };
+    auto set_page = [&](uint32_t page) {
+        if (page != batch_page) {
+            flush();
+            batch_page = page;
         }
-        for (const auto& vertex : drawable->getVertices()) {
-            vertex_array.append(vertex);
+    };
+    // Get the viewport of the view
+    sf::FloatRect viewport = getViewport(target.getView());
+    /**
+    The static objects of each chunk are already sorted by y position, and so are
+    the drawables, so they only have to be merged rather than sorted every frame.
+    The cursors keep track of the next static object to draw in each chunk.
+    The lightweight entities (with a Sprite or an animation) are kept sorted by
+    the draw order, and merged in the same way.
+    */
+    std::vector<const Chunk*> &visible_chunks = draw_chunks;
+    chunk_map.getChunks(viewport, visible_chunks);
+    std::vector<std::size_t> &cursors = draw_cursors;
+    cursors.assign(visible_chunks.size(), 0);
+    std::size_t drawable_index = 0;
+    draw_order.update(registry, viewport, interpolation_alpha);
+    const std::vector<ecs::DrawOrder::Entry> &sprite_entries = draw_order.getVisibleEntries();
+    std::size_t sprite_index = 0;
+    const float infinity = std::numeric_limits<float>::infinity();
+    while (true) {
+        // Find the static object furthest up
+        int next_chunk = -1;
+        float next_top = std::numeric_limits<float>::infinity();
+        for (std::size_t i = 0; i < visible_chunks.size(); i++) {
+            const std::vector<AABB> &aabbs = visible_chunks[i]->getStaticAABBs();
+            if (cursors[i] < aabbs.size() && aabbs[cursors[i]].top < next_top) {
+                next_chunk = i;
+                next_top = aabbs[cursors[i]].top;
+            }
+        }
+        bool has_drawable = drawable_index < drawables.size();
+        bool has_sprite = sprite_index < sprite_entries.size();
+        float drawable_top = has_drawable ? drawables[drawable_index]->getAABB().top : infinity;
+        float sprite_top = has_sprite ? sprite_entries[sprite_index].y : infinity;
+        if (next_chunk != -1 && next_top < drawable_top && next_top < sprite_top) {
+            const Chunk &chunk = *visible_chunks[next_chunk];
+            std::size_t index = cursors[next_chunk]++;
+            // Check if the static object is in the view
+            if (!viewport.intersects(chunk.getStaticAABBs()[index])) {
+                continue;
+            }
+            set_page(chunk.getStaticPages()[index]);
+            for (std::size_t i = index * 4; i < index * 4 + 4; i++) {
+                vertex_array.append(chunk.getStaticVertices()[i]);
+            }
+        } else if (has_drawable && drawable_top <= sprite_top) {
+            const GameObject *drawable = drawables[drawable_index++];
+            // Check if the drawable is in the view
+            if (!viewport.intersects(drawable->getAABB())) {
+                continue;
+            }
+            set_page(drawable->getPage());
+            sf::Vector2f offset = drawable->getInterpolationOffset(interpolation_alpha);
+            for (sf::Vertex vertex : drawable->getVertices()) {
+                vertex.position += offset;
+                vertex_array.append(vertex);
+            }
+        } else if (has_sprite) {
+            // Already culled to the view
+            const ecs::DrawOrder::Entry &entry = sprite_entries[sprite_index++];
+            set_page(ecs::DrawOrder::getPage(registry, entry));
+            ecs::DrawOrder::appendQuad(registry, entry, interpolation_alpha, vertex_array);
+        } else {
+            break;
         }
     }
-    // Draw the vertex array
-    states.texture = &game_registry.getTextureAtlas();
-    target.draw(vertex_array, states);
+    flush();
 }
 
 void World::drawDebug(sf::RenderTarget &target, sf::RenderStates states) const {
@@ -136,8 +228,15 @@ void World::drawDebug(sf::RenderTarget &target, sf::RenderStates states) const {
 }
 
 void World::createTile(const sf::Vector2i& position, const std::string &registry_name) {
-    Tile tile(sf::Vector2f(position), game_registry.getTileData(registry_name));
+    resources::GameRegistry::TileData data = game_registry.getTileData(registry_name);
+    Tile tile(sf::Vector2f(position), data);
     tiles[position.x + position.y * dimensions.x] = tile;
+    if (chunk_map.isSolid(position.x, position.y) != data.solid) {
+        chunk_map.setSolid(position.x, position.y, data.solid);
+        path_finder.invalidateTile(position.x, position.y);
+        flow_field.invalidate();
+    }
+    tile_window.invalidate();
     // This would probably be more efficient to do for all the tiles once we've added them all
     // For editing the world in real time this is a lot nicer though
     // connectTileToNeighbours(tile);
@@ -149,22 +248,136 @@ void World::createTile(const sf::Vector2i& position, const std::string &registry
 }
 
 void World::createGameObject(const sf::Vector2i& position, const std::string &registry_name) {
-    std::shared_ptr<GameObject> game_object = std::make_shared<GameObject>(sf::Vector2f(position), game_registry.getObjectData(registry_name));
-    game_objects.push_back(game_object);
-    // GameObject *game_object_ptr = const_cast<GameObject*>(&game_object);
-    // drawables.push_back(game_object_ptr);
-    drawables.push_back(game_object.get());
+    // Static objects are owned by their chunk, and baked on the next update
+    chunk_map.createStaticObject(sf::Vector2f(position), game_registry.getObjectData(registry_name));
+}
+
+ObjectHandle World::createMobileObject(const sf::Vector2i& position, const std::string &registry_name) {
+    ObjectHandle handle = mobile_objects.create(sf::Vector2f(position), game_registry.getObjectData(registry_name));
+    MobileObject *mobile_object = mobile_objects.get(handle);
+    mobile_object->setChunkMap(&chunk_map);
+    drawables.push_back(mobile_object);
+    sweep_and_prune.insert(mobile_object);
+    return handle;
+}
+
+void World::destroyMobileObject(ObjectHandle handle) {
+    MobileObject *mobile_object = mobile_objects.get(handle);
+    if (mobile_object == nullptr) {
+        return;
+    }
+    drawables.erase(std::find(drawables.begin(), drawables.end(), mobile_object));
+    sweep_and_prune.remove(mobile_object);
+    mobile_objects.destroy(handle);
+}
+
+void World::spawnEntities(const std::string &registry_name, const std::vector<sf::Vector2f> &positions,
+    std::vector<ecs::EntityHandle> &entities, bool chase_player) {
+    // Everything that's the same for the whole batch is resolved up front
+    const resources::GameRegistry::EntityData data = game_registry.getEntityData(registry_name);
+    resources::ResourceManager &resource_manager = game_registry.getResourceManager();
+    uint32_t table_id = getAnimationTable(data);
+    // Standing still to start with, the Animator takes over from the first update
+    const AnimationTable::Slot &idle = animation_tables[table_id].get(AnimationTable::IDLE, AnimationTable::DOWN);
+    resources::AnimationClipId clip_id = idle.clip;
+    if (clip_id == resources::AnimationClip::INVALID_ID && !data.animations.empty()) {
+        clip_id = data.animations.begin()->second;
+    }
+    ecs::Sprite sprite;
+    if (clip_id == resources::AnimationClip::INVALID_ID) {
+        const resources::VertexQuad &vertex_quad = resource_manager.getVertexQuad(data.texture_id);
+        sprite.texture_id = data.texture_id;
+        sprite.texture_rect = vertex_quad.getTextureRect();
+        sprite.page = vertex_quad.getPage();
+    }
+    ecs::Collider collider{data.footprint.getPosition(), data.footprint.getSize()};
+    ecs::Health health{(int) data.max_health, (int) data.max_health};
+    // Allocate for the whole batch at once, and only in the stores that the batch uses
+    bool animated = clip_id != resources::AnimationClip::INVALID_ID;
+    ecs::AnimationBatch &animation_batch = registry.getAnimationBatch();
+    registry.getStore<ecs::Position>().reserveAdditional(positions.size());
+    registry.getStore<ecs::Velocity>().reserveAdditional(positions.size());
+    registry.getStore<ecs::Collider>().reserveAdditional(positions.size());
+    registry.getStore<ecs::Health>().reserveAdditional(positions.size());
+    if (chase_player) {
+        registry.getStore<ecs::FlowFieldFollower>().reserveAdditional(positions.size());
+    }
+    if (animated) {
+        animation_batch.reserveAdditional(positions.size());
+        registry.getStore<ecs::Animator>().reserveAdditional(positions.size());
+    } else {
+        registry.getStore<ecs::Sprite>().reserveAdditional(positions.size());
+    }
+    if (entities.size() + positions.size() > entities.capacity()) {
+        entities.reserve(std::max(entities.size() + positions.size(), entities.capacity() * 2));
+    }
+    for (const sf::Vector2f &position : positions) {
+        ecs::EntityHandle entity = registry.create();
+        registry.getStore<ecs::Position>().add(entity, {position, position});
+        registry.getStore<ecs::Velocity>().add(entity);
+        registry.getStore<ecs::Collider>().add(entity, collider);
+        registry.getStore<ecs::Health>().add(entity, health);
+        if (chase_player) {
+            registry.getStore<ecs::FlowFieldFollower>().add(entity);
+        }
+        // Animated entities are drawn by the animation batch instead of a Sprite
+        if (animated) {
+            animation_batch.add(entity, clip_id, resource_manager.getAnimation(clip_id), idle.flip);
+            registry.getStore<ecs::Animator>().add(entity, {table_id, sf::Vector2f()});
+        } else {
+            registry.getStore<ecs::Sprite>().add(entity, sprite);
+        }
+        entities.push_back(entity);
+    }
+}
+
+uint32_t World::getAnimationTable(const resources::GameRegistry::EntityData &data) {
+    auto it = animation_table_ids.find(data.registry_name);
+    if (it != animation_table_ids.end()) {
+        return it->second;
+    }
+    uint32_t table_id = animation_tables.size();
+    animation_tables.emplace_back(data);
+    animation_table_ids[data.registry_name] = table_id;
+    return table_id;
 }
 
 void World::createPlayer(const sf::Vector2i& position) {
     this->player = std::make_unique<Player>(sf::Vector2f(position), game_registry.getEntityData("entity.player"));
-    GameObject *player_ptr = this->player.get();
-    drawables.push_back(player_ptr);
+    this->player->setChunkMap(&chunk_map);
+    drawables.push_back(this->player.get());
+    sweep_and_prune.insert(this->player.get());
+}
+
+void World::refreshAnimations(const std::vector<resources::AnimationClipId> &clip_ids) {
+    resources::ResourceManager &resource_manager = game_registry.getResourceManager();
+    ecs::AnimationBatch &animation_batch = registry.getAnimationBatch();
+    for (resources::AnimationClipId clip_id : clip_ids) {
+        animation_batch.refreshClip(clip_id, resource_manager.getAnimation(clip_id));
+    }
 }
 
-void World::updateView(sf::View &view) const {
-    // Update the view to follow the player
-    view.setCenter(player->getPosition());
+void World::refreshTextures() {
+    for (Tile &tile : tiles) {
+        tile.refreshTexture();
+    }
+    tile_window.invalidate();
+    chunk_map.refreshTextures();
+    player->refreshTexture();
+    mobile_objects.forEach([](MobileObject &mobile_object) {
+        mobile_object.refreshTexture();
+    });
+    const resources::ResourceManager &resource_manager = game_registry.getResourceManager();
+    for (ecs::Sprite &sprite : registry.getStore<ecs::Sprite>().getComponents()) {
+        const resources::VertexQuad &vertex_quad = resource_manager.getVertexQuad(sprite.texture_id);
+        sprite.texture_rect = vertex_quad.getTextureRect();
+        sprite.page = vertex_quad.getPage();
+    }
+}
+
+void World::updateView(sf::View &view) {
+    // Update the view to follow the player (where it's drawn, not where it is)
+    view.setCenter(player->getInterpolatedPosition(interpolation_alpha));
     // Check if the view is outside the world
     if (view.getCenter().x - view.getSize().x / 2.0f < 0) {
         // Set the view to the left edge of the world
@@ -191,6 +404,8 @@ void World::updateView(sf::View &view) const {
         // Set the view to the height of the world
         view.setCenter(view.getCenter().x, dimensions.y / 2.0f);
     }
+    // Only the tiles that were scrolled into view are rebuilt
+    tile_window.update(view, [this](int x, int y) { return getTile(x, y); });
 }
 
 bool World::isPointInWorld(const sf::Vector2f &point) const {
@@ -198,6 +413,27 @@ bool World::isPointInWorld(const sf::Vector2f &point) const {
            point.y >= 0 && point.y <= dimensions.y;
 }
 
+void World::resolveCollisions(MobileObject &mobile_object) {
+    /**
+    The world border and the static objects are already handled while the object
+    moves (see MobileObject::update()), so this only catches the overlaps left
+    behind by other mobile objects pushing the object into something.
+    */
+    const AABB &aabb = mobile_object.getAABB();
+    chunk_map.getChunks(aabb, collision_chunks);
+    for (const Chunk *chunk : collision_chunks) {
+        for (const AABB &other : chunk->getStaticAABBs()) {
+            // The AABBs are sorted by their top, so the rest are all below us
+            if (other.top >= aabb.top + aabb.height) {
+                break;
+            }
+            if (mobile_object.isColliding(other)) {
+                mobile_object.resolveCollision(other);
+            }
+        }
+    }
+}
+
 const Tile* World::getTile(int x, int y) const {
     if (x < 0 || x >= dimensions.x || y < 0 || y >= dimensions.y) {
         return nullptr;
@@ -247,22 +483,6 @@ sf::FloatRect World::getViewport(const sf::View &view) const {
     return viewport;
 }
 
-std::vector<const Tile*> World::getVisibleTiles(const sf::FloatRect &viewport) const {
-    std::vector<const Tile*> visible_tiles;
-    int x_start = std::max(0, (int) viewport.left);
-    int x_end = std::min((int) (viewport.left + viewport.width), dimensions.x);
-    int y_start = std::max(0, (int) viewport.top);
-    int y_end = std::min((int) (viewport.top + viewport.height), dimensions.y);
-    
-    for (int x = x_start; x <= x_end; x++) {
-        for (int y = y_start; y <= y_end; y++) {
-            visible_tiles.push_back(getTile(x, y));
-        }
-    }
-    return visible_tiles;
-}
-
-
 void World::generateWorld() {
     std::vector<sf::Vector2i> initial_perimeter = generatePerimeter();
     std::vector<sf::Vector2i> perimeter;
@@ -301,6 +521,7 @@ void World::generateWorld() {
             }
         }
     }
+    chunk_map.bake();
 }
 
 std::vector<sf::Vector2i> World::generatePerimeter() {
@@ -1,16 +1,26 @@
 #include <iostream>
+#include <algorithm>
 
 #include "engine/game_state/game_state_manager.hpp"
 #include "engine/game_state/states/startup_state.hpp"
 #include "resources/game_registry.hpp"
 #include "engine/window_singleton.hpp"
 #include "engine/constants.hpp"
+#include "engine/job_system.hpp"
 
 // Generally I try to avoid using the "using" keyword, but I'm lazy right now
 using namespace rpg::engine; 
 using namespace rpg::resources;
 
+/**
+ * Usage: rpg [resources]
+ * The resources can be a folder or an archive of one (see rpg_assetbake),
+ * and default to the resources folder next to the source code.
+*/
 int main(int argc, char const *argv[]) {
+    if (argc > 1) {
+        GameRegistry::setResourcesFolder(argv[1]);
+    }
     // Create the main window
     static int window_width = 800;
     static int window_height = window_width / constants::ASPECT_RATIO;
@@ -19,12 +29,17 @@ int main(int argc, char const *argv[]) {
     WindowSingleton &window_singleton = WindowSingleton::getInstance();
     window_singleton.setWindow(&window);
 
+    // Start the worker threads before anything can schedule jobs
+    JobSystem::getInstance().start(constants::JOB_THREAD_COUNT);
+
     // Get the game registry
     GameRegistry &game_registry = GameRegistry::getInstance();
     
     // Create a clock to measure elapsed time
     sf::Clock clock;
     sf::Time delta_time;
+    // Time that has passed but hasn't been simulated yet
+    float accumulator = 0.0f;
 
     // Create the game state manager
     game_state::GameStateManager game_state_manager(nullptr);
@@ -51,11 +66,19 @@ int main(int argc, char const *argv[]) {
         window.clear();
         // Update the clock
         delta_time = clock.restart();
-        float delta = delta_time.asSeconds();
-        // Handle continuous actions (e.g. moving the player)
-        game_state_manager.handleContinuousInput();
-        // Update the game state
-        game_state_manager.update(delta);
+        float delta = std::min(delta_time.asSeconds(), constants::MAX_FRAME_TIME);
+        // Advance the simulation in fixed ticks, no matter how long the frame took
+        accumulator += delta;
+        while (accumulator >= constants::SIMULATION_TICK) {
+            // Handle continuous actions (e.g. moving the player)
+            game_state_manager.handleContinuousInput();
+            // Update the game state
+            game_state_manager.update(constants::SIMULATION_TICK);
+            accumulator -= constants::SIMULATION_TICK;
+        }
+        game_state_manager.updateUI(delta);
+        // Draw everything somewhere between the last two ticks
+        game_state_manager.interpolate(accumulator / constants::SIMULATION_TICK);
         // Update the view
         window.setView(game_state_manager.getView());
         // Draw the game state
@@ -65,5 +88,6 @@ int main(int argc, char const *argv[]) {
         std::cout << "FPS: " << 1.0f / delta << std::endl;
     }
 
+    JobSystem::getInstance().stop();
     return 0;
 }
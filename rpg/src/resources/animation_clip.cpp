@@ -0,0 +1,39 @@
+#include "resources/animation_clip.hpp"
+
+namespace rpg {
+namespace resources {
+
+AnimationClip::AnimationClip(const std::vector<sf::IntRect> &frames, int frame_rate, bool loop) {
+    if (frames.size() == 0) {
+        throw std::invalid_argument("Animation must have at least one frame");
+    }
+    if (frame_rate <= 0) {
+        throw std::invalid_argument("Frame rate must be positive");
+    }
+    this->frames = frames;
+    this->frame_rate = frame_rate;
+    this->loop = loop;
+}
+
+std::size_t AnimationClip::getFrameIndex(float time) const {
+    if (time <= 0) {
+        return 0;
+    }
+    std::size_t index = static_cast<std::size_t>(time * frame_rate);
+    if (loop) {
+        return index % frames.size();
+    }
+    return index < frames.size() ? index : frames.size() - 1;
+}
+
+void AnimationClip::moveTo(const sf::Vector2f &position) {
+    // Calcluate the offset to move the animation by
+    sf::Vector2f offset = position - sf::Vector2f(frames[0].left, frames[0].top);
+    for (auto &frame : frames) {
+        frame.left += offset.x;
+        frame.top += offset.y;
+    }
+}
+
+} // namespace resources
+} // namespace rpg
\ No newline at end of file
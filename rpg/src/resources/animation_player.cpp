@@ -0,0 +1,25 @@
+#include "resources/animation_player.hpp"
+
+#include <cmath>
+
+namespace rpg {
+namespace resources {
+
+void AnimationPlayer::play(AnimationClipId clip) {
+    if (this->clip != clip) {
+        this->clip = clip;
+        time = 0;
+    }
+}
+
+void AnimationPlayer::advance(const AnimationClip &clip, float dt) {
+    time += dt;
+    float duration = clip.getDuration();
+    if (time >= duration) {
+        // Wrap looping clips so the time doesn't lose precision, and clamp the rest
+        time = clip.isLooping() ? std::fmod(time, duration) : duration;
+    }
+}
+
+} // namespace resources
+} // namespace rpg
@@ -0,0 +1,85 @@
+#include "resources/asset_pack.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace rpg {
+namespace resources {
+
+AssetPackWriter::AssetPackWriter(uint32_t magic, uint32_t version) {
+    write(magic);
+    write(version);
+}
+
+void AssetPackWriter::writeString(const std::string &value) {
+    write(static_cast<uint32_t>(value.size()));
+    writeBytes(value.data(), value.size());
+}
+
+void AssetPackWriter::writeRect(const sf::IntRect &rect) {
+    write(static_cast<int32_t>(rect.left));
+    write(static_cast<int32_t>(rect.top));
+    write(static_cast<int32_t>(rect.width));
+    write(static_cast<int32_t>(rect.height));
+}
+
+void AssetPackWriter::writeBytes(const void *data, std::size_t size) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    buffer.insert(buffer.end(), bytes, bytes + size);
+}
+
+void AssetPackWriter::align(std::size_t alignment) {
+    buffer.resize((buffer.size() + alignment - 1) / alignment * alignment, 0);
+}
+
+void AssetPackWriter::save(const std::filesystem::path &path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size())) {
+        throw std::runtime_error("AssetPackWriter::" + std::string(__func__) + "(): Could not write asset pack: " + path.string());
+    }
+}
+
+AssetPackReader::AssetPackReader(const std::filesystem::path &path) : AssetPackReader(VirtualFileSystem::map(path), path.string()) {}
+
+AssetPackReader::AssetPackReader(const VirtualFileSystem::File &file, const std::string &name, uint32_t magic, uint32_t version) : file(file) {
+    if (file.size < sizeof(uint32_t) * 2 || read<uint32_t>() != magic) {
+        throw std::runtime_error("AssetPackReader::" + std::string(__func__) + "(): Not an asset pack: " + name);
+    }
+    uint32_t file_version = read<uint32_t>();
+    if (file_version != version) {
+        throw std::runtime_error("AssetPackReader::" + std::string(__func__) + "(): Asset pack version " + std::to_string(file_version) +
+            " doesn't match " + std::to_string(version) + ", bake the assets again: " + name);
+    }
+}
+
+std::string AssetPackReader::readString() {
+    uint32_t size = read<uint32_t>();
+    const uint8_t *bytes = readBytes(size);
+    return std::string(reinterpret_cast<const char*>(bytes), size);
+}
+
+sf::IntRect AssetPackReader::readRect() {
+    sf::IntRect rect;
+    rect.left = read<int32_t>();
+    rect.top = read<int32_t>();
+    rect.width = read<int32_t>();
+    rect.height = read<int32_t>();
+    return rect;
+}
+
+const uint8_t* AssetPackReader::readBytes(std::size_t size) {
+    if (size > file.size - offset) {
+        throw std::runtime_error("AssetPackReader::" + std::string(__func__) + "(): Unexpected end of asset pack");
+    }
+    const uint8_t *bytes = file.data + offset;
+    offset += size;
+    return bytes;
+}
+
+void AssetPackReader::align(std::size_t alignment) {
+    std::size_t aligned = (offset + alignment - 1) / alignment * alignment;
+    readBytes(aligned - offset);
+}
+
+} // namespace resources
+} // namespace rpg
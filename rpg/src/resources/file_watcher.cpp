@@ -0,0 +1,117 @@
+#include "resources/file_watcher.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace rpg {
+namespace resources {
+
+#ifdef __linux__
+
+FileWatcher::FileWatcher(const std::filesystem::path &root) : root(root) {
+    inotify_descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_descriptor < 0) {
+        throw std::runtime_error("FileWatcher::" + std::string(__func__) + "(): Could not initialise inotify");
+    }
+    // inotify isn't recursive, so every folder needs a watch of its own
+    std::vector<std::filesystem::path> folders = {root};
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root)) {
+        if (entry.is_directory()) {
+            folders.push_back(entry.path());
+        }
+    }
+    for (const std::filesystem::path &folder : folders) {
+        int watch = inotify_add_watch(inotify_descriptor, folder.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (watch >= 0) {
+            watches[watch] = folder;
+        }
+    }
+    if (watches.empty()) {
+        close(inotify_descriptor);
+        throw std::runtime_error("FileWatcher::" + std::string(__func__) + "(): Could not watch " + root.string());
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    if (inotify_descriptor >= 0) {
+        close(inotify_descriptor);
+    }
+}
+
+void FileWatcher::poll(std::vector<std::filesystem::path> &changed) {
+    alignas(inotify_event) char buffer[4096];
+    while (true) {
+        ssize_t length = read(inotify_descriptor, buffer, sizeof(buffer));
+        // EAGAIN once there's nothing left to read
+        if (length <= 0) {
+            break;
+        }
+        for (char *position = buffer; position < buffer + length;) {
+            const inotify_event *event = reinterpret_cast<const inotify_event*>(position);
+            position += sizeof(inotify_event) + event->len;
+            auto watch = watches.find(event->wd);
+            if (event->len == 0 || watch == watches.end()) {
+                continue;
+            }
+            std::filesystem::path path = watch->second / event->name;
+            if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+                changed.push_back(path);
+            }
+        }
+    }
+}
+
+#else
+
+FileWatcher::FileWatcher(const std::filesystem::path &root) : root(root) {
+    if (!std::filesystem::is_directory(root)) {
+        throw std::runtime_error("FileWatcher::" + std::string(__func__) + "(): Could not watch " + root.string());
+    }
+    scan(nullptr);
+    next_scan = std::chrono::steady_clock::now() + POLL_INTERVAL;
+}
+
+FileWatcher::~FileWatcher() = default;
+
+void FileWatcher::poll(std::vector<std::filesystem::path> &changed) {
+    auto now = std::chrono::steady_clock::now();
+    if (now < next_scan) {
+        return;
+    }
+    next_scan = now + POLL_INTERVAL;
+    scan(&changed);
+}
+
+void FileWatcher::scan(std::vector<std::filesystem::path> *changed) {
+    std::error_code error;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(root, error)) {
+        if (!entry.is_regular_file(error)) {
+            continue;
+        }
+        std::filesystem::file_time_type write_time = entry.last_write_time(error);
+        if (error) {
+            continue;
+        }
+        auto [it, inserted] = write_times.try_emplace(entry.path().string(), write_time);
+        if (!inserted && it->second != write_time) {
+            it->second = write_time;
+            if (changed != nullptr) {
+                changed->push_back(entry.path());
+            }
+        } else if (inserted && changed != nullptr) {
+            // A new file, e.g. one that was saved by renaming it into place
+            changed->push_back(entry.path());
+        }
+    }
+}
+
+#endif
+
+} // namespace resources
+} // namespace rpg
@@ -4,9 +4,17 @@
 #include <iostream>
 #include <filesystem>
 #include <fstream>
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <optional>
 
 #include "rectpack2D-master/src/finders_interface.h"
 #include "nlohmann/json.hpp"
+#include "engine/job_system.hpp"
+#include "resources/virtual_file_system.hpp"
 
 namespace rpg {
 namespace resources {
@@ -17,25 +25,82 @@ GameRegistry& GameRegistry::getInstance() {
 }
 
 GameRegistry::GameRegistry() {
-    // TODO: Do this automatically
-    // this->assets_path = "D:/Random-Code/rpg/assets";
-    this->font.loadFromFile(getResourcesFolder() + "/fonts/PixeloidSans-mLxMm.TTF");
+    // Everything below is read through the file system, from a folder or an archive
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    file_system.mount(getResourcesFolder());
+    std::string font_path = getResourcesFolder() + "/fonts/PixeloidSans-mLxMm.TTF";
+    if (file_system.exists(font_path)) {
+        font_file = file_system.open(font_path);
+        this->font.loadFromMemory(font_file.data, font_file.size);
+    }
     // Register some stuff
-    registerEntry("entity.player");
-    registerEntry("object.rock");
-    registerEntry("object.bush_short");
-    registerEntry("object.bush_tall");
-    registerEntry("object.tree_stump");
-    registerEntry("object.crate");
-    registerEntry("object.chest");
-    registerEntry("tile.grass");
-    registerEntry("tile.dirt");
-    registerEntry("tile.water");
-    registerEntry("tile.water_shallow");
-    registerEntry("tile.sand");
-    registerEntry("ui.button");
-    registerEntry("ui.menu");
+    const std::vector<std::string> entries = {
+        "entity.player",
+        "object.rock",
+        "object.bush_short",
+        "object.bush_tall",
+        "object.tree_stump",
+        "object.crate",
+        "object.chest",
+        "tile.grass",
+        "tile.dirt",
+        "tile.water",
+        "tile.water_shallow",
+        "tile.sand",
+        "ui.button",
+        "ui.menu"
+    };
+    // An archive is a snapshot of the folder, pack and all, so its pack can't be out of date
+    // A pack in a folder is only used if it was baked from the files that are there now
+    std::vector<std::filesystem::path> source_paths;
+    if (!file_system.isArchive()) {
+        source_paths = findSourcePaths(entries);
+        source_files = listSourceFiles(source_paths);
+    }
+    // The baked assets skip decoding the images and packing the atlas, see asset_pack.hpp
+    if (use_pack && file_system.exists(getPackPath())) {
+        std::cout << "Loading asset pack: " << getPackPath() << std::endl;
+        std::optional<AssetPackReader> reader;
+        try {
+            reader.emplace(file_system.open(getPackPath()), getPackPath().string());
+        } catch (const std::runtime_error &exception) {
+            // e.g. a pack baked by an older version of the game
+            std::cout << exception.what() << std::endl;
+        }
+        if (reader && loadPack(*reader, "", source_files)) {
+            return;
+        }
+        std::cout << "The asset pack is out of date, loading the resources folder instead. Bake the assets again to use it" << std::endl;
+    }
+    // Only the atlas cache has to read the files, since a touched file may not have changed
+    if (!file_system.isArchive()) {
+        source_key = computeCacheKey(entries, source_paths);
+    }
+    // Otherwise the atlas from the last launch is reused, unless any of the files changed
+    // An archive can't be written to, and should have a pack baked into it anyway
+    bool cache_enabled = use_cache && !file_system.isArchive();
+    if (cache_enabled && loadCache(source_key)) {
+        return;
+    }
+    auto build_start = std::chrono::steady_clock::now();
+    resource_manager.loadDefaultTexture();
+    // Decode all of the images across the job system first, registering the
+    // entries afterwards only has to read the json files and store the rects
+    std::vector<std::filesystem::path> texture_paths;
+    for (const std::string &entry : entries) {
+        std::vector<std::filesystem::path> paths = findTexturePaths(entry);
+        texture_paths.insert(texture_paths.end(), paths.begin(), paths.end());
+    }
+    resource_manager.decodeImages(texture_paths);
+    for (const std::string &entry : entries) {
+        registerEntry(entry);
+    }
+    // Composes the images and uploads them to the GPU once
     buildTextureAtlas();
+    if (cache_enabled) {
+        auto build_time = std::chrono::steady_clock::now() - build_start;
+        saveCache(source_key, std::chrono::duration_cast<std::chrono::milliseconds>(build_time).count());
+    }
 }
 
 GameRegistry::TileData GameRegistry::createTileData(const std::string &name, const std::string &prefix) {
@@ -45,8 +110,18 @@ GameRegistry::TileData GameRegistry::createTileData(const std::string &name, con
     data.registry_name = registry_name;
     // Load the sprite
     loadTexture(name, prefix);
+    setTextureIds(data);
     // Get the sprite rect
     // data.sprite = &sprite_manager.getSprite(registry_name);
+    // Check if the tile has a json file
+    std::string tile_json_path = getResourcesFolder() + "/" + TILE_PREFIX + "/" + name + TILE_JSON_SUFFIX;
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    if (prefix == TILE_PREFIX && file_system.exists(tile_json_path)) {
+        std::cout << "Found tile file: " << tile_json_path << std::endl;
+        VirtualFileSystem::File file = file_system.open(tile_json_path);
+        nlohmann::json json = nlohmann::json::parse(file.begin(), file.end());
+        data.solid = json.value("solid", false);
+    }
     return data;
 }
 
@@ -59,16 +134,19 @@ GameRegistry::ObjectData GameRegistry::createObjectData(const std::string &name,
     // Add tile data to object data
     ObjectData data;
     data.registry_name = tile_data.registry_name;
+    data.texture_id = tile_data.texture_id;
+    data.connected_texture_id = tile_data.connected_texture_id;
     // data.sprite = tile_data.sprite;
     // Data for the footprint
     sf::Vector2f footprint_position, footprint_dimensions;
     // Check if the object has a json file
     std::string object_json_path = getResourcesFolder() + "/" + OBJECT_PREFIX + "/" + name + OBJECT_JSON_SUFFIX;
-    if (std::filesystem::exists(object_json_path)) {
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    if (file_system.exists(object_json_path)) {
         std::cout << "Found object file: " << object_json_path << std::endl;
         // Load the footprint from the json file
-        std::ifstream file(object_json_path);
-        nlohmann::json json = nlohmann::json::parse(file);
+        VirtualFileSystem::File file = file_system.open(object_json_path);
+        nlohmann::json json = nlohmann::json::parse(file.begin(), file.end());
         auto footprint = json["footprint"];
         footprint_position = sf::Vector2f(footprint["position"]["x"], footprint["position"]["y"]);
         footprint_dimensions = sf::Vector2f(footprint["dimensions"]["width"], footprint["dimensions"]["height"]);
@@ -91,14 +169,15 @@ GameRegistry::EntityData GameRegistry::createEntityData(const std::string &name,
     // Add object data to entity data
     EntityData data;
     data.registry_name = object_data.registry_name;
+    data.texture_id = object_data.texture_id;
+    data.connected_texture_id = object_data.connected_texture_id;
     // data.sprite = object_data.sprite;
     data.footprint = object_data.footprint;
     // Load all the animations for the entity
     std::string entity_folder = getResourcesFolder() + "/" + ENTITY_PREFIX + "/" + name;
     // Create a map of all the animations
-    std::map<std::string, Animation&> animations;
-    for (const auto &entry : std::filesystem::directory_iterator(entity_folder)) {
-        std::filesystem::path path = entry.path();
+    std::map<std::string, AnimationClipId> animations;
+    for (const std::filesystem::path &path : VirtualFileSystem::getInstance().list(entity_folder)) {
         // Check if the file is an image
         if (!path.has_extension() || path.extension().string() != ".png") {
             continue;
@@ -107,7 +186,7 @@ GameRegistry::EntityData GameRegistry::createEntityData(const std::string &name,
         resource_manager.loadTexture(path, registry_name);
         // Check if the animation exists
         if (resource_manager.hasAnimation(registry_name)) {
-            animations.insert({registry_name, resource_manager.getAnimation(registry_name)});
+            animations.insert({registry_name, resource_manager.getAnimationId(registry_name)});
         }
     }
     data.animations = animations;
@@ -160,7 +239,7 @@ void GameRegistry::loadTexture(const std::string &name, const std::string &prefi
     // Generate the texture path
     std::string texture_path = generateTexturePath(name, prefix);
     // Check if the path points to a valid file
-    if (std::filesystem::exists(texture_path)) {
+    if (VirtualFileSystem::getInstance().exists(texture_path)) {
         // Load the texture
         resource_manager.loadTexture(texture_path, registry_name);
     } else {
@@ -169,9 +248,359 @@ void GameRegistry::loadTexture(const std::string &name, const std::string &prefi
     }
 }
 
+void GameRegistry::savePack(const std::filesystem::path &path) const {
+    AssetPackWriter writer;
+    writer.writeString(source_key);
+    writer.write<uint32_t>(source_files.size());
+    for (const SourceFile &source_file : source_files) {
+        writer.writeString(source_file.path);
+        writer.write(source_file.size);
+        writer.write(source_file.write_time);
+    }
+    resource_manager.savePack(writer);
+    writer.write<uint32_t>(tiles.size());
+    for (const auto &[registry_name, data] : tiles) {
+        writer.writeString(registry_name);
+        writer.write<uint8_t>(data.solid);
+    }
+    auto write_object_data = [&writer](const ObjectData &data) {
+        writer.write<uint8_t>(data.solid);
+        writer.write(data.footprint.left);
+        writer.write(data.footprint.top);
+        writer.write(data.footprint.width);
+        writer.write(data.footprint.height);
+    };
+    writer.write<uint32_t>(objects.size());
+    for (const auto &[registry_name, data] : objects) {
+        writer.writeString(registry_name);
+        write_object_data(data);
+    }
+    writer.write<uint32_t>(entities.size());
+    for (const auto &[registry_name, data] : entities) {
+        writer.writeString(registry_name);
+        write_object_data(data);
+        writer.write<uint32_t>(data.max_health);
+        // The ids are looked up again when loading
+        writer.write<uint32_t>(data.animations.size());
+        for (const auto &animation : data.animations) {
+            writer.writeString(animation.first);
+        }
+    }
+    writer.save(path);
+}
+
+bool GameRegistry::loadPack(AssetPackReader &reader, const std::string &key, const std::vector<SourceFile> &source_files) {
+    std::string pack_key = reader.readString();
+    if (!key.empty() && pack_key != key) {
+        return false;
+    }
+    std::vector<SourceFile> pack_source_files(reader.read<uint32_t>());
+    for (SourceFile &source_file : pack_source_files) {
+        source_file.path = reader.readString();
+        source_file.size = reader.read<uint64_t>();
+        source_file.write_time = reader.read<int64_t>();
+    }
+    if (!source_files.empty() && pack_source_files != source_files) {
+        return false;
+    }
+    source_key = pack_key;
+    this->source_files = std::move(pack_source_files);
+    resource_manager.loadPack(reader);
+    uint32_t tile_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < tile_count; i++) {
+        TileData data;
+        data.registry_name = reader.readString();
+        data.solid = reader.read<uint8_t>();
+        setTextureIds(data);
+        tiles[data.registry_name] = data;
+    }
+    auto read_object_data = [this, &reader](ObjectData &data) {
+        data.registry_name = reader.readString();
+        data.solid = reader.read<uint8_t>();
+        float left = reader.read<float>();
+        float top = reader.read<float>();
+        float width = reader.read<float>();
+        float height = reader.read<float>();
+        data.footprint = engine::AABB(sf::Vector2f(left, top), sf::Vector2f(width, height));
+        setTextureIds(data);
+    };
+    uint32_t object_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < object_count; i++) {
+        ObjectData data;
+        read_object_data(data);
+        objects[data.registry_name] = data;
+    }
+    uint32_t entity_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < entity_count; i++) {
+        EntityData data;
+        read_object_data(data);
+        data.max_health = reader.read<uint32_t>();
+        uint32_t animation_count = reader.read<uint32_t>();
+        for (uint32_t j = 0; j < animation_count; j++) {
+            std::string animation_name = reader.readString();
+            data.animations.insert({animation_name, resource_manager.getAnimationId(animation_name)});
+        }
+        entities[data.registry_name] = data;
+    }
+    return true;
+}
+
+/**
+ * 64-bit FNV-1a, which is plenty to tell if any of the files changed.
+*/
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+static constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+static uint64_t hashBytes(const void *data, std::size_t size, uint64_t hash = FNV_OFFSET_BASIS) {
+    const uint8_t *bytes = static_cast<const uint8_t*>(data);
+    for (std::size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+template <typename T>
+static uint64_t hashValue(const T &value, uint64_t hash) {
+    return hashBytes(&value, sizeof(T), hash);
+}
+
+static uint64_t hashString(const std::string &value, uint64_t hash) {
+    // The size keeps e.g. "ab" + "c" and "a" + "bc" apart
+    return hashBytes(value.data(), value.size(), hashValue<uint64_t>(value.size(), hash));
+}
+
+std::vector<std::filesystem::path> GameRegistry::findSourcePaths(const std::vector<std::string> &entries) {
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    std::vector<std::filesystem::path> paths = {getResourcesFolder() + "/missing.png"};
+    std::vector<std::string> directories;
+    for (const std::string &entry : entries) {
+        std::string directory = getDirectory(entry);
+        if (std::find(directories.begin(), directories.end(), directory) != directories.end() || !file_system.isDirectory(directory)) {
+            continue;
+        }
+        directories.push_back(directory);
+        std::vector<std::filesystem::path> files = file_system.list(directory);
+        paths.insert(paths.end(), files.begin(), files.end());
+    }
+    // Directory iterators don't have a fixed order
+    std::sort(paths.begin(), paths.end());
+    return paths;
+}
+
+std::vector<GameRegistry::SourceFile> GameRegistry::listSourceFiles(const std::vector<std::filesystem::path> &paths) {
+    std::filesystem::path resources_folder = std::filesystem::path(getResourcesFolder()).lexically_normal();
+    std::vector<SourceFile> source_files(paths.size());
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        source_files[i].path = paths[i].lexically_normal().lexically_relative(resources_folder).generic_string();
+        // Error codes rather than exceptions, a missing file is just one that doesn't match
+        std::error_code error;
+        uintmax_t size = std::filesystem::file_size(paths[i], error);
+        if (error) {
+            continue;
+        }
+        std::filesystem::file_time_type write_time = std::filesystem::last_write_time(paths[i], error);
+        if (error) {
+            continue;
+        }
+        source_files[i].size = size;
+        source_files[i].write_time = write_time.time_since_epoch().count();
+    }
+    return source_files;
+}
+
+std::string GameRegistry::computeCacheKey(const std::vector<std::string> &entries, const std::vector<std::filesystem::path> &paths) {
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    // Reading the files is the slow part, so that's spread across the job system
+    std::vector<uint64_t> content_hashes(paths.size(), 0);
+    engine::JobSystem::getInstance().parallelFor(0, paths.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            if (!file_system.exists(paths[i])) {
+                continue;
+            }
+            try {
+                VirtualFileSystem::File file = file_system.open(paths[i]);
+                content_hashes[i] = hashBytes(file.data, file.size);
+            } catch (const std::exception &exception) {
+                // Left as 0, a file that can't be read still changes the hash once it can be
+                std::cout << "GameRegistry::computeCacheKey(): " << exception.what() << std::endl;
+            }
+        }
+    }, "GameRegistry::computeCacheKey");
+    std::filesystem::path resources_folder = std::filesystem::path(getResourcesFolder()).lexically_normal();
+    uint64_t hash = hashValue(AssetPackWriter::VERSION, FNV_OFFSET_BASIS);
+    for (const std::string &entry : entries) {
+        hash = hashString(entry, hash);
+    }
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        hash = hashString(paths[i].lexically_normal().lexically_relative(resources_folder).generic_string(), hash);
+        hash = hashValue(content_hashes[i], hash);
+    }
+    std::stringstream key;
+    key << std::hex << std::setw(16) << std::setfill('0') << hash;
+    return key.str();
+}
+
+bool GameRegistry::loadCache(const std::string &key) {
+    std::filesystem::path index_path = getCacheFolder() / CACHE_INDEX_FILENAME;
+    std::filesystem::path pack_path = getCacheFolder() / CACHE_PACK_FILENAME;
+    if (!std::filesystem::exists(index_path) || !std::filesystem::exists(pack_path)) {
+        std::cout << "Atlas cache miss: no cache in " << getCacheFolder() << std::endl;
+        return false;
+    }
+    std::ifstream file(index_path);
+    nlohmann::json index = nlohmann::json::parse(file, nullptr, false);
+    if (index.is_discarded() || index.value("key", "") != key) {
+        std::cout << "Atlas cache miss: the resources changed" << std::endl;
+        return false;
+    }
+    auto load_start = std::chrono::steady_clock::now();
+    std::cout << "Loading asset pack: " << pack_path << std::endl;
+    AssetPackReader reader(pack_path);
+    if (!loadPack(reader, key, {})) {
+        std::cout << "Atlas cache miss: the pack doesn't match its index" << std::endl;
+        return false;
+    }
+    auto load_time = std::chrono::steady_clock::now() - load_start;
+    long long load_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(load_time).count();
+    long long build_milliseconds = index.value("build_milliseconds", 0LL);
+    std::cout << "Atlas cache hit: loaded in " << load_milliseconds << " ms, saved about "
+              << std::max(build_milliseconds - load_milliseconds, 0LL) << " ms" << std::endl;
+    return true;
+}
+
+void GameRegistry::saveCache(const std::string &key, long long build_milliseconds) const {
+    std::filesystem::path pack_path = getCacheFolder() / CACHE_PACK_FILENAME;
+    std::filesystem::path index_path = getCacheFolder() / CACHE_INDEX_FILENAME;
+    try {
+        std::filesystem::create_directories(getCacheFolder());
+        // The old index must never point at the new pack
+        std::filesystem::remove(index_path);
+        // Written next to the old cache first, so a crash never leaves half a pack behind
+        std::filesystem::path temporary_path = pack_path;
+        temporary_path += ".tmp";
+        savePack(temporary_path);
+        std::filesystem::rename(temporary_path, pack_path);
+        nlohmann::json index;
+        index["key"] = key;
+        index["build_milliseconds"] = build_milliseconds;
+        std::ofstream file(index_path, std::ios::trunc);
+        file << index.dump(4);
+    } catch (const std::exception &exception) {
+        // The game works fine without the cache, it just starts slower
+        std::cout << "GameRegistry::" + std::string(__func__) + "(): Could not save the atlas cache: " << exception.what() << std::endl;
+        return;
+    }
+    std::cout << "Atlas cache saved to " << getCacheFolder() << " (built in " << build_milliseconds << " ms)" << std::endl;
+}
+
+void GameRegistry::setTextureIds(TileData &data) const {
+    data.texture_id = resource_manager.getTextureId(data.registry_name);
+    data.connected_texture_id = resource_manager.getConnectedTextureId(data.registry_name);
+}
+
+void GameRegistry::enableHotReload() {
+    if (VirtualFileSystem::getInstance().isArchive()) {
+        std::cout << "Can't hot reload from an archive: " << getResourcesFolder() << std::endl;
+        return;
+    }
+    try {
+        file_watcher = std::make_unique<FileWatcher>(getResourcesFolder());
+        std::cout << "Hot reloading " << getResourcesFolder() << std::endl;
+    } catch (const std::exception &exception) {
+        std::cout << "GameRegistry::" + std::string(__func__) + "(): " << exception.what() << std::endl;
+    }
+}
+
+bool GameRegistry::pollHotReload(std::vector<AnimationClipId> &reloaded_clips) {
+    if (file_watcher == nullptr) {
+        return false;
+    }
+    std::vector<std::filesystem::path> changed;
+    file_watcher->poll(changed);
+    for (const std::filesystem::path &path : changed) {
+        std::string registry_name = getRegistryNameForFile(path);
+        if (registry_name.empty()) {
+            continue;
+        }
+        auto reload_start = std::chrono::steady_clock::now();
+        std::string filename = path.filename().string();
+        auto ends_with = [&filename](const std::string &suffix) {
+            return filename.size() >= suffix.size() && filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+        };
+        // A half written file shouldn't take the game down with it
+        try {
+            if (ends_with(ResourceManager::ANIMATION_EXTENSION)) {
+                resource_manager.reloadAnimation(path, registry_name);
+            } else if (ends_with(ResourceManager::VARIATIONS_EXTENSION)) {
+                resource_manager.reloadVariations(path, registry_name);
+            } else if (ends_with(".png")) {
+                resource_manager.reloadTexture(path, registry_name);
+            } else {
+                continue;
+            }
+        } catch (const std::exception &exception) {
+            std::cout << "GameRegistry::" + std::string(__func__) + "(): Could not reload " << path << ": " << exception.what() << std::endl;
+            continue;
+        }
+        if (resource_manager.hasAnimation(registry_name)) {
+            reloaded_clips.push_back(resource_manager.getAnimationId(registry_name));
+        }
+        auto reload_time = std::chrono::steady_clock::now() - reload_start;
+        std::cout << "Hot reloaded " << path << " in "
+                  << std::chrono::duration_cast<std::chrono::microseconds>(reload_time).count() / 1000.0f << " ms" << std::endl;
+    }
+    // Textures are patched in once their images are decoded, and the ones that
+    // outgrew their rect are swapped in once the repack is done
+    resource_manager.pollTextureReloads();
+    if (!resource_manager.pollRepack()) {
+        return false;
+    }
+    // Every frame of every clip might have moved
+    for (AnimationClipId clip_id{0}; clip_id.index < resource_manager.animation_clips.size(); clip_id.index++) {
+        reloaded_clips.push_back(clip_id);
+    }
+    return true;
+}
+
+std::string GameRegistry::getRegistryNameForFile(const std::filesystem::path &path) {
+    std::filesystem::path relative = path.lexically_normal().lexically_relative(std::filesystem::path(getResourcesFolder()).lexically_normal());
+    // The first folder is the prefix, e.g. resources/tile/grass.png or resources/entity/player/player_idle_down.png
+    auto part = relative.begin();
+    if (relative.empty() || part == relative.end() || std::next(part) == relative.end()) {
+        return "";
+    }
+    std::string prefix = part->string();
+    if (prefix != TILE_PREFIX && prefix != OBJECT_PREFIX && prefix != ENTITY_PREFIX && prefix != "ui") {
+        return "";
+    }
+    // Everything up to the first dot, so "grass.variations.json" is "grass" too
+    std::string filename = relative.filename().string();
+    std::string name = filename.substr(0, filename.find('.'));
+    // Connected textures are stored as e.g. "tile.dirt_connected", see ResourceManager::loadConnectedTexture()
+    for (const char *extension : {ResourceManager::CONNECTED_TEXTURE_BLOB_EXTENSION, ResourceManager::CONNECTED_TEXTURE_FENCE_EXTENSION}) {
+        std::string suffix = std::string(extension).substr(0, std::string(extension).find('.'));
+        if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            name = name.substr(0, name.size() - suffix.size()) + "_connected";
+            break;
+        }
+    }
+    return getRegistryName(name, prefix);
+}
+
+std::filesystem::path GameRegistry::getCacheFolder() {
+    return std::filesystem::path(getResourcesFolder()) / CACHE_FOLDER;
+}
+
+std::filesystem::path GameRegistry::getPackPath() {
+    return std::filesystem::path(getResourcesFolder()) / PACK_FILENAME;
+}
+
 std::string GameRegistry::getResourcesFolder() {
-    // Do something more elegant here
-    return "D:/Random-Code/rpg/resources";
+    if (resources_folder.empty()) {
+        const char *environment_folder = std::getenv("RPG_RESOURCES");
+        resources_folder = environment_folder != nullptr ? environment_folder : RPG_RESOURCES_FOLDER;
+    }
+    return resources_folder;
 }
 
 std::string GameRegistry::getDirectory(const std::string &registry_name) {
@@ -183,6 +612,24 @@ std::string GameRegistry::getDirectory(const std::string &registry_name) {
     return getResourcesFolder() + "/" + prefix;
 }
 
+std::vector<std::filesystem::path> GameRegistry::findTexturePaths(const std::string &registry_name) {
+    std::vector<std::filesystem::path> paths;
+    std::string name, prefix;
+    splitRegistryName(registry_name, name, prefix);
+    std::string directory = getDirectory(registry_name);
+    for (const std::filesystem::path &path : VirtualFileSystem::getInstance().list(directory)) {
+        if (!path.has_extension() || path.extension().string() != ".png") {
+            continue;
+        }
+        // Entities have a folder to themselves, everything else shares one with the rest of its type
+        std::string stem = path.stem().string();
+        if (prefix == ENTITY_PREFIX || stem == name || stem.rfind(name + "_", 0) == 0) {
+            paths.push_back(path);
+        }
+    }
+    return paths;
+}
+
 std::string GameRegistry::generateTexturePath(const std::string &name, const std::string &prefix) {
     /**
      * In the future this might have to be more specific to each of the
@@ -0,0 +1,104 @@
+#include "resources/mapped_file.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace rpg {
+namespace resources {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    file_handle = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        file_handle = nullptr;
+        throw std::runtime_error("MappedFile::" + std::string(__func__) + "(): Could not open file: " + path.string());
+    }
+    LARGE_INTEGER file_size;
+    GetFileSizeEx(file_handle, &file_size);
+    size = static_cast<std::size_t>(file_size.QuadPart);
+    // Empty files can't be mapped, but there's nothing to read anyway
+    if (size == 0) {
+        return;
+    }
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle != nullptr) {
+        data = static_cast<const uint8_t*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (data == nullptr) {
+        close();
+        throw std::runtime_error("MappedFile::" + std::string(__func__) + "(): Could not map file: " + path.string());
+    }
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+        data = nullptr;
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+    }
+    if (file_handle != nullptr) {
+        CloseHandle(file_handle);
+        file_handle = nullptr;
+    }
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    file_descriptor = open(path.c_str(), O_RDONLY);
+    if (file_descriptor < 0) {
+        throw std::runtime_error("MappedFile::" + std::string(__func__) + "(): Could not open file: " + path.string());
+    }
+    struct stat file_stat;
+    fstat(file_descriptor, &file_stat);
+    size = static_cast<std::size_t>(file_stat.st_size);
+    // Empty files can't be mapped, but there's nothing to read anyway
+    if (size == 0) {
+        return;
+    }
+    void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    if (mapping == MAP_FAILED) {
+        close();
+        throw std::runtime_error("MappedFile::" + std::string(__func__) + "(): Could not map file: " + path.string());
+    }
+    data = static_cast<const uint8_t*>(mapping);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+void MappedFile::close() {
+    if (data != nullptr) {
+        munmap(const_cast<uint8_t*>(data), size);
+        data = nullptr;
+    }
+    if (file_descriptor >= 0) {
+        ::close(file_descriptor);
+        file_descriptor = -1;
+    }
+}
+
+#endif
+
+} // namespace resources
+} // namespace rpg
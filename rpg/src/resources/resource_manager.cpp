@@ -3,22 +3,47 @@
 #include "resources/connected_textures/fence_texture.hpp"
 #include "resources/connected_textures/blob_texture.hpp"
 #include "resources/vertex_quad.hpp"
+#include "resources/virtual_file_system.hpp"
 #include "engine/constants.hpp"
+#include "engine/job_system.hpp"
 #include "rectpack2D-master/src/finders_interface.h"
 #include <nlohmann/json.hpp>
 
 #include <iostream>
 #include <filesystem>
-#include <fstream>
+#include <cstring>
+#include <algorithm>
 
 namespace rpg {
 namespace resources {
 
-ResourceManager::ResourceManager() {
-    if (!default_texture.loadFromFile(GameRegistry::getResourcesFolder() + "/missing.png")) {
+/**
+ * Decode an image from the virtual file system.
+ * The png is decoded straight from the mapped file, nothing is copied first.
+*/
+static bool loadImage(const std::filesystem::path &path, sf::Image &image) {
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    if (!file_system.exists(path)) {
+        std::cout << "Image not found: " << path << std::endl;
+        return false;
+    }
+    VirtualFileSystem::File file = file_system.open(path);
+    return image.loadFromMemory(file.data, file.size);
+}
+
+/**
+ * Parse a json file from the virtual file system.
+*/
+static nlohmann::json loadJson(const std::filesystem::path &path) {
+    VirtualFileSystem::File file = VirtualFileSystem::getInstance().open(path);
+    return nlohmann::json::parse(file.begin(), file.end());
+}
+
+void ResourceManager::loadDefaultTexture() {
+    if (!loadImage(GameRegistry::getResourcesFolder() + "/missing.png", default_image)) {
         throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Could not load default texture.");
     }
-    setTexture("default", default_texture, sf::IntRect(0, 0, default_texture.getSize().x, default_texture.getSize().y));
+    setTexture("default", default_image, sf::IntRect(0, 0, default_image.getSize().x, default_image.getSize().y));
 }
 
 void ResourceManager::loadTexture(const std::filesystem::path &path, const std::string &registry_name) {
@@ -28,7 +53,7 @@ void ResourceManager::loadTexture(const std::filesystem::path &path, const std::
         return;
     }
     // Check if the path points to a valid file
-    if (!std::filesystem::exists(path)) {
+    if (!VirtualFileSystem::getInstance().exists(path)) {
         std::cout << "ResourceManager::" + std::string(__func__) + "(): Path does not point to a valid file: " << path << std::endl;
         return;
     }
@@ -38,27 +63,23 @@ void ResourceManager::loadTexture(const std::filesystem::path &path, const std::
         return;
     }
     // Check if texture is already loaded
-    auto it = textures.find(registry_name);
     // If it's not loaded, attempt to load it
-    if (it == textures.end()) {
-        // The texture is initially loaded as an image
-        sf::Image image;
-        if (image.loadFromFile(path.string())) { // loadFromFile will notifiy the user if it fails
-            // Create a texture from the image
-            sf::Texture texture;
-            texture.loadFromImage(image);
+    if (getTextureId(registry_name) == INVALID_TEXTURE_ID) {
+        // The texture stays an image until the texture atlas is built
+        DecodedImage decoded_image;
+        if (takeDecodedImage(path, decoded_image)) { // loadFromMemory will notify the user if it fails
+            const sf::Image &image = decoded_image.image;
             // Create a sprite rect for the texture atlas
             sf::IntRect texture_rect = sf::IntRect(0, 0, image.getSize().x, image.getSize().y);
             // Add the texture to the map
-            setTexture(registry_name, texture, texture_rect);
+            setTexture(registry_name, image, texture_rect);
             std::cout << "Loaded texture: " << path << std::endl;
             // Check if we loaded any extra files
             if (!loadExtraFiles(path, registry_name)) {
                 // If we didn't load anything extra crop the texture to remove any transparent pixels
-                texture_rect = getMinimumRect(image);
-                texture.loadFromImage(cropImage(image, texture_rect));
+                texture_rect = decoded_image.minimum_rect;
                 // Overwrite with the cropped texture
-                setTexture(registry_name, texture, texture_rect);
+                setTexture(registry_name, cropImage(image, texture_rect), texture_rect);
             }
         }
     } else {
@@ -66,24 +87,81 @@ void ResourceManager::loadTexture(const std::filesystem::path &path, const std::
     }
 }
 
-const sf::IntRect ResourceManager::getTextureRect(const std::string &registry_name) {
-    return getVertexQuad(registry_name).getTextureRect();
+void ResourceManager::decodeImages(const std::vector<std::filesystem::path> &paths) {
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    std::vector<std::filesystem::path> pending;
+    for (const std::filesystem::path &path : paths) {
+        if (file_system.exists(path) && decoded_images.find(getImageKey(path)) == decoded_images.end()) {
+            pending.push_back(path);
+        }
+    }
+    // Every job writes to its own slot, so nothing has to be locked
+    std::vector<DecodedImage> results(pending.size());
+    std::vector<uint8_t> loaded(pending.size(), 0);
+    engine::JobSystem::getInstance().parallelFor(0, pending.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            if (loadImage(pending[i], results[i].image)) {
+                results[i].minimum_rect = getMinimumRect(results[i].image);
+                loaded[i] = 1;
+            }
+        }
+    }, "ResourceManager::decodeImages");
+    for (std::size_t i = 0; i < pending.size(); i++) {
+        if (loaded[i]) {
+            decoded_images[getImageKey(pending[i])] = std::move(results[i]);
+        }
+    }
+    std::cout << "Decoded " << pending.size() << " images" << std::endl;
+}
+
+TextureId ResourceManager::getTextureId(const std::string &registry_name) const {
+    auto it = texture_ids.find(registry_name);
+    return it == texture_ids.end() ? INVALID_TEXTURE_ID : it->second;
+}
+
+TextureId ResourceManager::getConnectedTextureId(const std::string &registry_name) const {
+    TextureId id = getTextureId(registry_name + "_connected");
+    return hasConnectedTexture(id) ? id : INVALID_TEXTURE_ID;
+}
+
+std::string ResourceManager::getTextureName(TextureId id) const {
+#ifndef NDEBUG
+    if (id.index < texture_names.size()) {
+        return texture_names[id.index];
+    }
+#endif
+    return "#" + std::to_string(id.index);
 }
 
-const VertexQuad& ResourceManager::getVertexQuad(const std::string &registry_name) {
+TextureId ResourceManager::registerTexture(const std::string &registry_name) {
+    auto [it, inserted] = texture_ids.insert({registry_name, TextureId{static_cast<uint32_t>(vertex_quads.size())}});
+    if (inserted) {
+        vertex_quads.emplace_back();
+        animations.push_back(AnimationClip::INVALID_ID);
+        variations.emplace_back();
+        connected_textures.emplace_back();
+#ifndef NDEBUG
+        texture_names.push_back(registry_name);
+#endif
+    }
+    return it->second;
+}
+
+const sf::IntRect ResourceManager::getTextureRect(const std::string &registry_name) {
+    TextureId id = getTextureId(registry_name);
     // If it's not loaded, return the default vertices
-    if (vertex_quads.find(registry_name) == vertex_quads.end()) {
+    if (id == INVALID_TEXTURE_ID) {
         std::cout << "Vertex quad not loaded: " << registry_name << ". Returning default vertex quads." << std::endl;
-        return default_vertex_quad;
     }
-    return vertex_quads.at(registry_name);
+    return getVertexQuad(id).getTextureRect();
 }
 
 bool ResourceManager::hasAnimation(const std::string &registry_name) {
-    return animations.find(registry_name) != animations.end();
+    TextureId id = getTextureId(registry_name);
+    return id != INVALID_TEXTURE_ID && animations[id.index] != AnimationClip::INVALID_ID;
 }
 
-Animation& ResourceManager::getAnimation(const std::string &registry_name) {
+AnimationClipId ResourceManager::getAnimationId(const std::string &registry_name) {
     // If it's not loaded, return the default animation
     if (!hasAnimation(registry_name)) {
         // std::cout << "Animation not loaded: " << registry_name ". Returning default animation." << std::endl;
@@ -91,125 +169,328 @@ Animation& ResourceManager::getAnimation(const std::string &registry_name) {
         // TODO: Return default animation instead of throwing an error
         throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Animation not loaded: " + registry_name);
     }
-    return animations.at(registry_name);
+    return animations[getTextureId(registry_name).index];
 }
 
-bool ResourceManager::hasVariations(const std::string &registry_name) {
-    return variations.find(registry_name) != variations.end();
+bool ResourceManager::packRects(const std::vector<sf::Vector2i> &sizes, std::vector<sf::IntRect> &rects, std::vector<uint32_t> &pages,
+    std::vector<sf::Vector2i> &page_sizes, std::size_t &too_large, int max_side) {
+    // Bunch of setup stuff
+    constexpr bool allow_flip = false;
+	const auto runtime_flipping_mode = rectpack2D::flipping_option::DISABLED;
+    using spaces_type = rectpack2D::empty_spaces<allow_flip, rectpack2D::default_empty_spaces>;
+    using rect_type = rectpack2D::output_rect_t<spaces_type>;
+    const int discard_step = -4;
+    rects.assign(sizes.size(), sf::IntRect());
+    pages.assign(sizes.size(), 0);
+    page_sizes.clear();
+    // Indices of the rectangles that haven't been put on a page yet
+    std::vector<std::size_t> remaining(sizes.size());
+    for (std::size_t i = 0; i < remaining.size(); i++) {
+        remaining[i] = i;
+    }
+    while (!remaining.empty()) {
+        uint32_t page = page_sizes.size();
+        std::vector<rect_type> page_rectangles;
+        for (std::size_t i : remaining) {
+            page_rectangles.push_back(rect_type(0, 0, sizes[i].x, sizes[i].y));
+        }
+        // Whatever doesn't fit is skipped, and tried again on the next page
+        std::vector<uint8_t> spilled(page_rectangles.size(), 0);
+        auto report_successful = [](rect_type&) {
+            return rectpack2D::callback_result::CONTINUE_PACKING;
+        };
+        auto report_unsuccessful = [&](rect_type &rect) {
+            spilled[&rect - page_rectangles.data()] = 1;
+            return rectpack2D::callback_result::CONTINUE_PACKING;
+        };
+        // Pack the rectangles into the page
+        const auto result_size = rectpack2D::find_best_packing<spaces_type>(
+            page_rectangles,
+            make_finder_input(
+                max_side,
+                discard_step,
+                report_successful,
+                report_unsuccessful,
+                runtime_flipping_mode
+            )
+        );
+        std::vector<std::size_t> next_remaining;
+        for (std::size_t i = 0; i < page_rectangles.size(); i++) {
+            if (spilled[i]) {
+                next_remaining.push_back(remaining[i]);
+                continue;
+            }
+            const rect_type &r = page_rectangles[i];
+            rects[remaining[i]] = sf::IntRect(r.x, r.y, r.w, r.h);
+            pages[remaining[i]] = page;
+        }
+        // Nothing fit on an empty page, so it never will
+        if (next_remaining.size() == remaining.size()) {
+            too_large = next_remaining[0];
+            return false;
+        }
+        page_sizes.push_back(sf::Vector2i(result_size.w, result_size.h));
+        remaining = std::move(next_remaining);
+    }
+    return true;
 }
 
-std::shared_ptr<WeightedTexture> ResourceManager::getVariations(const std::string &registry_name) {
-    // If it's not loaded, return the default variations
-    if (!hasVariations(registry_name)) {
-        // std::cout << "Variations not loaded: " << registry_name ". Returning default variations." << std::endl;
-        // return WeightedTexture();
-        throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Variations not loaded: " + registry_name);
+void ResourceManager::buildTextureAtlas() {
+    // The rects are indexed by texture id
+    std::vector<sf::Vector2i> sizes;
+    for (const VertexQuad &vertex_quad : vertex_quads) {
+        sizes.push_back(vertex_quad.getTextureRect().getSize());
+    }
+    std::vector<sf::IntRect> rects;
+    std::vector<uint32_t> pages;
+    std::vector<sf::Vector2i> page_sizes;
+    std::size_t too_large = 0;
+    // Each page is as large as the GPU allows, but only as large as it has to be
+    const int max_side = static_cast<int>(sf::Texture::getMaximumSize());
+    if (!packRects(sizes, rects, pages, page_sizes, too_large, max_side)) {
+        throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Texture is too large for the texture atlas: " + getTextureName(TextureId{static_cast<uint32_t>(too_large)}));
+    }
+    atlas_images.clear();
+    for (std::size_t page = 0; page < page_sizes.size(); page++) {
+        std::cout << "Texture atlas page " << page << ": " << page_sizes[page].x << " " << page_sizes[page].y << std::endl;
+        atlas_images.emplace_back().create(page_sizes[page].x, page_sizes[page].y, sf::Color::Transparent);
+    }
+    for (uint32_t index = 0; index < vertex_quads.size(); index++) {
+        const sf::IntRect &rect = rects[index];
+        std::cout << getTextureName(TextureId{index}) << ": " << rect.left << " " << rect.top << " " << rect.width << " " << rect.height << std::endl;
+        // Add the sprite to the texture atlas
+        atlas_images[pages[index]].copy(index < images.size() ? images[index] : default_image, rect.left, rect.top);
+        placeTexture(TextureId{index}, rect, pages[index]);
+    }
+    // Upload each page at once
+    texture_atlas_pages.clear();
+    texture_atlas_pages.resize(atlas_images.size());
+    for (std::size_t page = 0; page < atlas_images.size(); page++) {
+        if (!texture_atlas_pages[page].loadFromImage(atlas_images[page])) {
+            throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Could not create texture atlas page " + std::to_string(page));
+        }
     }
-    return variations.at(registry_name);
+    // The images are all in the texture atlas now
+    images.clear();
+    decoded_images.clear();
 }
 
-bool ResourceManager::hasConnectedTexture(const std::string &registry_name) {
-    return connected_textures.find(registry_name + "_connected") != connected_textures.end();
+void ResourceManager::placeTexture(TextureId id, const sf::IntRect &rect, uint32_t page) {
+    // Move the sprite rect to the new position
+    vertex_quads[id.index].setTextureRect(rect);
+    vertex_quads[id.index].setPage(page);
+    // Move animations, variations, and connected textures to the new position
+    if (animations[id.index] != AnimationClip::INVALID_ID) {
+        AnimationClip &clip = animation_clips[animations[id.index].index];
+        clip.moveTo(sf::Vector2f(rect.left, rect.top));
+        clip.setPage(page);
+    }
+    if (hasVariations(id)) {
+        // Variations are drawn with the quad, so they're on its page already
+        variations[id.index]->moveTo(sf::Vector2f(rect.left, rect.top));
+    }
+    if (hasConnectedTexture(id)) {
+        connected_textures[id.index]->moveTo(sf::Vector2f(rect.left, rect.top));
+        connected_textures[id.index]->setPage(page);
+    }
 }
 
-std::shared_ptr<connected_textures::ConnectedTexture> ResourceManager::getConnectedTexture(const std::string &registry_name) {
-    // If it's not loaded, return the default connected texture
-    if (!hasConnectedTexture(registry_name)) {
-        // std::cout << "Connected texture not loaded: " << registry_name ". Returning default connected texture." << std::endl;
-        // return ConnectedTexture();
-        throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Connected texture not loaded: " + registry_name);
+void ResourceManager::savePack(AssetPackWriter &writer) const {
+    // The pages are handed to the repack while it runs, see startRepack()
+    if (atlas_images.size() != texture_atlas_pages.size()) {
+        throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): The texture atlas is being repacked");
+    }
+    // The pixels are stored as is, so they can be uploaded without decoding anything
+    writer.write<uint32_t>(atlas_images.size());
+    for (const sf::Image &atlas_image : atlas_images) {
+        writer.write<uint32_t>(atlas_image.getSize().x);
+        writer.write<uint32_t>(atlas_image.getSize().y);
+        writer.align(4);
+        writer.writeBytes(atlas_image.getPixelsPtr(), atlas_image.getSize().x * atlas_image.getSize().y * 4);
+    }
+    // The names in order of id, so loading the pack hands out the same ids
+    std::vector<const std::string*> names(vertex_quads.size());
+    for (const auto &[registry_name, id] : texture_ids) {
+        names[id.index] = &registry_name;
+    }
+    // Texture rects (in the texture atlas)
+    writer.write<uint32_t>(vertex_quads.size());
+    for (TextureId id{0}; id.index < vertex_quads.size(); id.index++) {
+        writer.writeString(*names[id.index]);
+        writer.writeRect(vertex_quads[id.index].getTextureRect());
+        writer.write<uint32_t>(vertex_quads[id.index].getPage());
+    }
+    // Animations and connected textures are on the same page as their texture rects
+    // Animations
+    writer.write<uint32_t>(animation_clips.size());
+    for (TextureId id{0}; id.index < vertex_quads.size(); id.index++) {
+        if (animations[id.index] == AnimationClip::INVALID_ID) {
+            continue;
+        }
+        const AnimationClip &clip = animation_clips[animations[id.index].index];
+        writer.writeString(*names[id.index]);
+        writer.write<int32_t>(clip.getFrameRate());
+        writer.write<uint8_t>(clip.isLooping());
+        writer.write<uint32_t>(clip.getFrames().size());
+        for (const sf::IntRect &frame : clip.getFrames()) {
+            writer.writeRect(frame);
+        }
+    }
+    // Variations
+    writer.write<uint32_t>(std::count_if(variations.begin(), variations.end(), [](const auto &weighted_texture) { return weighted_texture != nullptr; }));
+    for (TextureId id{0}; id.index < vertex_quads.size(); id.index++) {
+        if (!hasVariations(id)) {
+            continue;
+        }
+        const std::shared_ptr<WeightedTexture> &weighted_texture = variations[id.index];
+        writer.writeString(*names[id.index]);
+        writer.write<uint32_t>(weighted_texture->getNumVariations());
+        for (int i = 0; i < weighted_texture->getNumVariations(); i++) {
+            writer.writeRect(weighted_texture->getVariations()[i]);
+            writer.write<int32_t>(weighted_texture->getWeights()[i]);
+        }
+    }
+    // Connected textures, whose rects are the texture rects of their textures
+    writer.write<uint32_t>(std::count_if(connected_textures.begin(), connected_textures.end(), [](const auto &connected_texture) { return connected_texture != nullptr; }));
+    for (TextureId id{0}; id.index < vertex_quads.size(); id.index++) {
+        if (!hasConnectedTexture(id)) {
+            continue;
+        }
+        const std::shared_ptr<connected_textures::ConnectedTexture> &connected_texture = connected_textures[id.index];
+        writer.writeString(*names[id.index]);
+        bool is_fence = dynamic_cast<const connected_textures::FenceTexture*>(connected_texture.get()) != nullptr;
+        writer.write(is_fence ? ConnectedTextureType::FENCE : ConnectedTextureType::BLOB);
     }
-    return connected_textures.at(registry_name + "_connected");
 }
 
-void ResourceManager::buildTextureAtlas() {
-    // Bunch of setup stuff
-    constexpr bool allow_flip = false;
-	const auto runtime_flipping_mode = rectpack2D::flipping_option::DISABLED;
-    using spaces_type = rectpack2D::empty_spaces<allow_flip, rectpack2D::default_empty_spaces>;
-    using rect_type = rectpack2D::output_rect_t<spaces_type>;
-    auto report_successful = [](rect_type&) {
-		return rectpack2D::callback_result::CONTINUE_PACKING;
-	};
-	auto report_unsuccessful = [](rect_type&) {
-		return rectpack2D::callback_result::ABORT_PACKING;
-	};
-    const unsigned int max_side = 1024;
-    texture_atlas.create(max_side, max_side);
-    const int discard_step = -4;
-    // Keep track of what rectangles end up where
-    std::vector<rect_type> rectangles;
-    std::vector<std::string> keys;
-    // TODO: Sort them based on size?
-    for (const auto &vertex_quad : vertex_quads) {
-        std::string key = vertex_quad.first;
-        sf::IntRect texture_rect = vertex_quad.second.getTextureRect();
-        rectangles.push_back(rect_type(texture_rect.left, texture_rect.top, texture_rect.width, texture_rect.height));
-        keys.push_back(key);
-    }
-    // Pack the rectangles into the texture atlas
-    const auto result_size = rectpack2D::find_best_packing<spaces_type>(
-        rectangles,
-        make_finder_input(
-            max_side,
-            discard_step,
-            report_successful,
-            report_unsuccessful,
-            runtime_flipping_mode
-        )
-    );
-    // Move the sprite rects to their new positions
-    std::cout << "Texture atlas: " << result_size.w << " " << result_size.h << std::endl;
-    for (unsigned int i = 0; i < rectangles.size(); i++) {
-        auto r = rectangles[i];
-        std::cout << keys[i] << ": " << r.x << " " << r.y << " " << r.w << " " << r.h << std::endl;
-        // Add the sprite to the texture atlas
-        texture_atlas.update(textures[keys[i]], r.x, r.y);
-        // Move the sprite rect to the new position
-        vertex_quads[keys[i]].setTextureRect(sf::IntRect(r.x, r.y, r.w, r.h));
-        // Move animations, variations, and connected textures to the new position
-        if (hasAnimation(keys[i])) {
-            animations.at(keys[i]).moveTo(sf::Vector2f(r.x, r.y));
+void ResourceManager::loadPack(AssetPackReader &reader) {
+    texture_atlas_pages.clear();
+    texture_atlas_pages.resize(reader.read<uint32_t>());
+    atlas_images.clear();
+    atlas_images.resize(texture_atlas_pages.size());
+    for (std::size_t page = 0; page < texture_atlas_pages.size(); page++) {
+        uint32_t width = reader.read<uint32_t>();
+        uint32_t height = reader.read<uint32_t>();
+        reader.align(4);
+        const uint8_t *pixels = reader.readBytes(width * height * 4);
+        if (!texture_atlas_pages[page].create(width, height)) {
+            throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Could not create the texture atlas");
         }
-        if (hasVariations(keys[i])) {
-            variations.at(keys[i])->moveTo(sf::Vector2f(r.x, r.y));
+        texture_atlas_pages[page].update(pixels);
+        // Copied from the pack now, rather than read back from the GPU on the first hot reload
+        atlas_images[page].create(width, height, pixels);
+    }
+    uint32_t vertex_quad_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < vertex_quad_count; i++) {
+        std::string registry_name = reader.readString();
+        sf::IntRect texture_rect = reader.readRect();
+        uint32_t page = reader.read<uint32_t>();
+        if (page >= texture_atlas_pages.size()) {
+            throw std::runtime_error("ResourceManager::" + std::string(__func__) + "(): Texture " + registry_name + " is on a missing page");
         }
-        /**
-        It is deliberate that we check for the connected texture manually here
-        instead of using hasConnectedTexture(). This is because the connected
-        texture is stored at registry_name + "_connected", which for ease of use
-        gets appended automatically in hasConnectedTexture().
-        */
-        if (connected_textures.find(keys[i]) != connected_textures.end()) {
-            connected_textures.at(keys[i])->moveTo(sf::Vector2f(r.x, r.y));
+        setVertexQuad(registry_name, texture_rect, page);
+    }
+    uint32_t animation_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < animation_count; i++) {
+        std::string registry_name = reader.readString();
+        int frame_rate = reader.read<int32_t>();
+        bool loop = reader.read<uint8_t>();
+        std::vector<sf::IntRect> frames(reader.read<uint32_t>());
+        for (sf::IntRect &frame : frames) {
+            frame = reader.readRect();
         }
+        TextureId id = registerTexture(registry_name);
+        animations[id.index] = AnimationClipId{static_cast<uint32_t>(animation_clips.size())};
+        animation_clips.emplace_back(frames, frame_rate, loop);
+        animation_clips.back().setPage(vertex_quads[id.index].getPage());
     }
-    texture_atlas.copyToImage().saveToFile("D:/Random-Code/rpg/resources/atlas.png");
+    uint32_t variations_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < variations_count; i++) {
+        std::string registry_name = reader.readString();
+        uint32_t count = reader.read<uint32_t>();
+        std::vector<sf::IntRect> variation_rects;
+        std::vector<int> weights;
+        for (uint32_t j = 0; j < count; j++) {
+            variation_rects.push_back(reader.readRect());
+            weights.push_back(reader.read<int32_t>());
+        }
+        variations[registerTexture(registry_name).index] = std::make_shared<WeightedTexture>(variation_rects, weights);
+    }
+    uint32_t connected_texture_count = reader.read<uint32_t>();
+    for (uint32_t i = 0; i < connected_texture_count; i++) {
+        std::string registry_name = reader.readString();
+        ConnectedTextureType type = reader.read<ConnectedTextureType>();
+        TextureId id = registerTexture(registry_name);
+        const VertexQuad &vertex_quad = vertex_quads[id.index];
+        sf::IntRect texture_rect = vertex_quad.getTextureRect();
+        sf::Vector2u texture_size(texture_rect.width, texture_rect.height);
+        std::shared_ptr<connected_textures::ConnectedTexture> connected_texture;
+        if (type == ConnectedTextureType::FENCE) {
+            connected_texture = std::make_shared<connected_textures::FenceTexture>(texture_size);
+        } else {
+            connected_texture = std::make_shared<connected_textures::BlobTexture>(texture_size);
+        }
+        connected_texture->moveTo(sf::Vector2f(texture_rect.left, texture_rect.top));
+        connected_texture->setPage(vertex_quad.getPage());
+        connected_textures[id.index] = connected_texture;
+    }
+    std::cout << "Loaded asset pack: " << vertex_quads.size() << " textures on " << texture_atlas_pages.size() << " pages, " << animation_clips.size() << " animations" << std::endl;
 }
 
-void ResourceManager::setTexture(const std::string &registry_name, const sf::Texture &texture, const sf::IntRect &texture_rect) {
-    textures[registry_name] = texture;
-    vertex_quads[registry_name].setTextureRect(texture_rect);
+void ResourceManager::setTexture(const std::string &registry_name, const sf::Image &image, const sf::IntRect &texture_rect) {
+    TextureId id = setVertexQuad(registry_name, texture_rect);
+    if (id.index >= images.size()) {
+        images.resize(id.index + 1);
+    }
+    images[id.index] = image;
+}
+
+TextureId ResourceManager::setVertexQuad(const std::string &registry_name, const sf::IntRect &texture_rect, uint32_t page) {
+    TextureId id = registerTexture(registry_name);
+    VertexQuad &vertex_quad = vertex_quads[id.index];
+    vertex_quad.setTextureRect(texture_rect);
+    vertex_quad.setPage(page);
     // TODO: Figure out if this is still necessary?
     // Scaling of the sprite is different for sprites used in the UI
     if (registry_name.find("ui") != std::string::npos) {
-        vertex_quads[registry_name].setScale(engine::constants::UI_SPRITE_SCALE);
-        // vertex_quads[registry_name].setScale(1.0f);
+        vertex_quad.setScale(engine::constants::UI_SPRITE_SCALE);
+        // vertex_quad.setScale(1.0f);
     } else {
-        vertex_quads[registry_name].setScale(engine::constants::WORLD_SPRITE_SCALE);
-        // vertex_quads[registry_name].setScale(1.0f);
+        vertex_quad.setScale(engine::constants::WORLD_SPRITE_SCALE);
+        // vertex_quad.setScale(1.0f);
     }
+    return id;
 }
 
-const sf::Texture& ResourceManager::getTexture(const std::string &registry_name) {
+const sf::Image& ResourceManager::getImage(const std::string &registry_name) {
     // Check if texture is already loaded
-    auto it = textures.find(registry_name);
+    TextureId id = getTextureId(registry_name);
     // If it's not loaded, return the default texture
-    if (it == textures.end()) {
+    if (id.index >= images.size()) {
         std::cout << "Texture not loaded: " << registry_name << ". Returning default texture." << std::endl;
-        return textures["default"];
+        return default_image;
+    }
+    return images[id.index];
+}
+
+bool ResourceManager::takeDecodedImage(const std::filesystem::path &path, DecodedImage &decoded_image) {
+    auto it = decoded_images.find(getImageKey(path));
+    if (it != decoded_images.end()) {
+        decoded_image = std::move(it->second);
+        decoded_images.erase(it);
+        return true;
+    }
+    // Not decoded ahead of time, so do it now
+    if (!loadImage(path, decoded_image.image)) {
+        return false;
     }
-    return textures[registry_name];
+    decoded_image.minimum_rect = getMinimumRect(decoded_image.image);
+    return true;
+}
+
+std::string ResourceManager::getImageKey(const std::filesystem::path &path) {
+    // The same file can be reached with different separators, e.g. from a directory iterator
+    return path.lexically_normal().generic_string();
 }
 
 bool ResourceManager::loadExtraFiles(const std::filesystem::path &path, const std::string &registry_name) {
@@ -222,20 +503,21 @@ bool ResourceManager::loadExtraFiles(const std::filesystem::path &path, const st
         dir_and_stem + CONNECTED_TEXTURE_FENCE_EXTENSION,
         dir_and_stem + CONNECTED_TEXTURE_BLOB_EXTENSION
     };
-    // Check if any of the files exist
+    // Check if any of the files exist, which is only a lookup in the index of the file system
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
     bool foundExtraFile = false;
-    if (std::filesystem::exists(animations_filename)) {
+    if (file_system.exists(animations_filename)) {
         std::cout << "Found animation file: " << animations_filename << std::endl;
         loadAnimation(animations_filename, registry_name);
         foundExtraFile = true;
     }
-    if (std::filesystem::exists(variations_filename)) {
+    if (file_system.exists(variations_filename)) {
         std::cout << "Found variation file: " << variations_filename << std::endl;
         loadVariations(variations_filename, registry_name);
         foundExtraFile = true;
     }
     for (const auto& filename : connected_texture_filenames) {
-        if (std::filesystem::exists(filename)) {
+        if (file_system.exists(filename)) {
             std::cout << "Found connected texture file: " << filename << std::endl;
             loadConnectedTexture(filename, registry_name);
             foundExtraFile = true;
@@ -245,41 +527,282 @@ bool ResourceManager::loadExtraFiles(const std::filesystem::path &path, const st
     return foundExtraFile;
 }
 
+bool ResourceManager::hasExtraFiles(const std::filesystem::path &path) {
+    std::filesystem::path path_copy = path;
+    std::string dir_and_stem = path_copy.replace_extension("").string();
+    VirtualFileSystem &file_system = VirtualFileSystem::getInstance();
+    for (const char *extension : {ANIMATION_EXTENSION, VARIATIONS_EXTENSION, CONNECTED_TEXTURE_FENCE_EXTENSION, CONNECTED_TEXTURE_BLOB_EXTENSION}) {
+        if (file_system.exists(dir_and_stem + extension)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResourceManager::reloadTexture(const std::filesystem::path &path, const std::string &registry_name) {
+    TextureId id = getTextureId(registry_name);
+    if (id == INVALID_TEXTURE_ID) {
+        std::cout << "ResourceManager::" + std::string(__func__) + "(): Texture not loaded: " << registry_name << std::endl;
+        return;
+    }
+    std::unique_ptr<TextureReload> reload = std::make_unique<TextureReload>();
+    reload->path = path;
+    reload->registry_name = registry_name;
+    reload->id = id;
+    // Cropped the same way loadTexture() does it, connected textures are never cropped
+    reload->crop = !hasConnectedTexture(id) && !hasExtraFiles(path);
+    // Decoding is the slow part, so the image is patched in once it's done, see pollTextureReloads()
+    engine::JobSystem &job_system = engine::JobSystem::getInstance();
+    job_system.schedule([job = reload.get()]() {
+        if (!loadImage(job->path, job->image)) {
+            return;
+        }
+        if (job->crop) {
+            job->image = cropImage(job->image, getMinimumRect(job->image));
+        }
+        job->loaded = true;
+    }, &reload->counter, "Reload texture");
+    // Without workers nobody else is going to run it
+    if (job_system.getThreadCount() == 0) {
+        job_system.wait(reload->counter);
+    }
+    texture_reloads.push_back(std::move(reload));
+}
+
+void ResourceManager::pollTextureReloads() {
+    engine::JobSystem &job_system = engine::JobSystem::getInstance();
+    // In the order they were started, so the latest version of a file wins
+    std::size_t done_count = 0;
+    for (; done_count < texture_reloads.size() && texture_reloads[done_count]->counter.isDone(); done_count++) {
+        TextureReload &reload = *texture_reloads[done_count];
+        try {
+            job_system.wait(reload.counter);
+        } catch (const std::exception &exception) {
+            std::cout << "ResourceManager::" + std::string(__func__) + "(): Could not reload " << reload.path << ": " << exception.what() << std::endl;
+            continue;
+        }
+        if (reload.loaded) {
+            applyTextureReload(reload);
+        }
+    }
+    texture_reloads.erase(texture_reloads.begin(), texture_reloads.begin() + done_count);
+}
+
+void ResourceManager::applyTextureReload(TextureReload &reload) {
+    const VertexQuad &vertex_quad = vertex_quads[reload.id.index];
+    const sf::IntRect texture_rect = vertex_quad.getTextureRect();
+    uint32_t page = vertex_quad.getPage();
+    sf::Vector2u size = reload.image.getSize();
+    // While a repack is running the rect is about to move, so the patch would be lost
+    if (repack == nullptr && static_cast<int>(size.x) <= texture_rect.width && static_cast<int>(size.y) <= texture_rect.height) {
+        // Fill the whole rect, so nothing of the old image is left over
+        sf::Image patch;
+        patch.create(texture_rect.width, texture_rect.height, sf::Color::Transparent);
+        patch.copy(reload.image, 0, 0);
+        texture_atlas_pages[page].update(patch, texture_rect.left, texture_rect.top);
+        atlas_images[page].copy(patch, texture_rect.left, texture_rect.top);
+        std::cout << "Reloaded texture in place: " << reload.registry_name << std::endl;
+        return;
+    }
+    // Growing the rect moves everything else, so the whole atlas is repacked
+    pending_images[reload.id] = std::move(reload.image);
+    startRepack();
+    std::cout << "Reloaded texture into the next repack: " << reload.registry_name << std::endl;
+}
+
+void ResourceManager::startRepack() {
+    if (repack != nullptr || pending_images.empty()) {
+        return;
+    }
+    repack = std::make_unique<Repack>();
+    // Handed over rather than copied, nothing patches the pages while the repack runs
+    repack->source_pages = std::move(atlas_images);
+    atlas_images.clear();
+    repack->changed.swap(pending_images);
+    std::vector<sf::Vector2i> sizes;
+    sizes.reserve(vertex_quads.size());
+    for (TextureId id{0}; id.index < vertex_quads.size(); id.index++) {
+        const VertexQuad &vertex_quad = vertex_quads[id.index];
+        repack->source_rects.push_back(vertex_quad.getTextureRect());
+        repack->source_page_ids.push_back(vertex_quad.getPage());
+        auto changed = repack->changed.find(id);
+        sizes.push_back(changed != repack->changed.end() ? sf::Vector2i(changed->second.getSize()) : vertex_quad.getTextureRect().getSize());
+    }
+    // Asking the GPU has to happen on this thread
+    const int max_side = static_cast<int>(sf::Texture::getMaximumSize());
+    engine::JobSystem &job_system = engine::JobSystem::getInstance();
+    job_system.schedule([job = repack.get(), sizes = std::move(sizes), max_side]() {
+        std::vector<sf::Vector2i> page_sizes;
+        if (!packRects(sizes, job->rects, job->page_ids, page_sizes, job->too_large, max_side)) {
+            job->failed = true;
+            return;
+        }
+        for (const sf::Vector2i &page_size : page_sizes) {
+            job->pages.emplace_back().create(page_size.x, page_size.y, sf::Color::Transparent);
+        }
+        for (TextureId id{0}; id.index < sizes.size(); id.index++) {
+            const sf::IntRect &rect = job->rects[id.index];
+            sf::Image &page = job->pages[job->page_ids[id.index]];
+            auto changed = job->changed.find(id);
+            if (changed != job->changed.end()) {
+                page.copy(changed->second, rect.left, rect.top);
+            } else {
+                page.copy(job->source_pages[job->source_page_ids[id.index]], rect.left, rect.top, job->source_rects[id.index]);
+            }
+        }
+    }, &repack->counter, "Repack texture atlas");
+    // Without workers nobody else is going to run it
+    if (job_system.getThreadCount() == 0) {
+        job_system.wait(repack->counter);
+    }
+}
+
+bool ResourceManager::pollRepack() {
+    if (repack == nullptr || !repack->counter.isDone()) {
+        return false;
+    }
+    std::unique_ptr<Repack> done = std::move(repack);
+    // Whatever goes wrong, the old atlas stays in use
+    atlas_images = std::move(done->source_pages);
+    try {
+        engine::JobSystem::getInstance().wait(done->counter);
+    } catch (const std::exception &exception) {
+        std::cout << "ResourceManager::" + std::string(__func__) + "(): Could not repack the texture atlas: " << exception.what() << std::endl;
+        startRepack();
+        return false;
+    }
+    if (done->failed) {
+        std::cout << "ResourceManager::" + std::string(__func__) + "(): Texture is too large for the texture atlas: " << getTextureName(TextureId{static_cast<uint32_t>(done->too_large)}) << std::endl;
+        startRepack();
+        return false;
+    }
+    // Upload everything first, so the old atlas stays in use if that fails
+    std::vector<sf::Texture> pages(done->pages.size());
+    for (std::size_t page = 0; page < pages.size(); page++) {
+        if (!pages[page].loadFromImage(done->pages[page])) {
+            std::cout << "ResourceManager::" + std::string(__func__) + "(): Could not create texture atlas page " << page << std::endl;
+            startRepack();
+            return false;
+        }
+    }
+    texture_atlas_pages.swap(pages);
+    atlas_images = std::move(done->pages);
+    for (const auto &[id, image] : done->changed) {
+        if (animations[id.index] != AnimationClip::INVALID_ID) {
+            // The image might have more (or fewer) frames now
+            AnimationClip &clip = animation_clips[animations[id.index].index];
+            clip = AnimationClip(getRects(image), clip.getFrameRate(), clip.isLooping());
+        }
+    }
+    for (TextureId id{0}; id.index < vertex_quads.size(); id.index++) {
+        placeTexture(id, done->rects[id.index], done->page_ids[id.index]);
+    }
+    std::cout << "Repacked the texture atlas: " << done->changed.size() << " changed textures, " << texture_atlas_pages.size() << " pages" << std::endl;
+    // Anything that was reloaded in the meantime
+    startRepack();
+    return true;
+}
+
+void ResourceManager::reloadAnimation(const std::filesystem::path &path, const std::string &registry_name) {
+    if (!hasAnimation(registry_name)) {
+        std::cout << "ResourceManager::" + std::string(__func__) + "(): Animation not loaded: " << registry_name << std::endl;
+        return;
+    }
+    nlohmann::json json = loadJson(path);
+    AnimationClip &clip = animation_clips[getAnimationId(registry_name).index];
+    uint32_t page = clip.getPage();
+    clip = AnimationClip(clip.getFrames(), json["frame_rate"], clip.isLooping());
+    clip.setPage(page);
+    std::cout << "Reloaded animation: " << registry_name << " (" << clip.getFrameRate() << " fps)" << std::endl;
+}
+
+void ResourceManager::reloadVariations(const std::filesystem::path &path, const std::string &registry_name) {
+    TextureId id = getTextureId(registry_name);
+    if (!hasVariations(id)) {
+        std::cout << "ResourceManager::" + std::string(__func__) + "(): Variations not loaded: " << registry_name << std::endl;
+        return;
+    }
+    nlohmann::json json = loadJson(path);
+    std::vector<int> weights;
+    for (auto& variation : json["variations"]) {
+        weights.push_back(variation["weight"]);
+    }
+    // Replaced in place, since tiles hold on to the collection
+    WeightedTexture &weighted_texture = *variations[id.index];
+    weighted_texture = WeightedTexture(weighted_texture.getVariations(), weights);
+    std::cout << "Reloaded variations: " << registry_name << std::endl;
+}
+
+/**
+ * Check if any pixel in a row of RGBA pixels isn't fully transparent.
+ * The alphas are ORed together without branching, so the compiler can vectorise
+ * the loop. Whole rows are tested, which is all getMinimumRect() needs for the
+ * top and bottom edges.
+*/
+static bool rowHasAlpha(const uint8_t *row, unsigned width) {
+    uint8_t alpha = 0;
+    for (unsigned x = 0; x < width; ++x) {
+        alpha |= row[x * 4 + 3];
+    }
+    return alpha != 0;
+}
+
 const sf::IntRect ResourceManager::getMinimumRect(const sf::Image &image) {
-    int minX = image.getSize().x, minY = image.getSize().y, maxX = 0, maxY = 0;
-    for (unsigned y = 0; y < image.getSize().y; ++y) {
-        for (unsigned x = 0; x < image.getSize().x; ++x) {
-            sf::Color pixel = image.getPixel(x, y);
-            if (pixel.a > 0) {  // Adjust this threshold as needed
-                minX = std::min(minX, static_cast<int>(x));
-                minY = std::min(minY, static_cast<int>(y));
-                maxX = std::max(maxX, static_cast<int>(x));
-                maxY = std::max(maxY, static_cast<int>(y));
+    const unsigned width = image.getSize().x;
+    const unsigned height = image.getSize().y;
+    const uint8_t *pixels = image.getPixelsPtr();
+    const std::size_t stride = static_cast<std::size_t>(width) * 4;
+    // Find the first and last rows with anything in them, stopping as soon as they're found
+    unsigned top = 0;
+    while (top < height && !rowHasAlpha(pixels + top * stride, width)) {
+        ++top;
+    }
+    // Nothing to trim if the image is empty or fully transparent
+    if (top == height) {
+        return sf::IntRect(0, 0, width, height);
+    }
+    unsigned bottom = height - 1;
+    while (bottom > top && !rowHasAlpha(pixels + bottom * stride, width)) {
+        --bottom;
+    }
+    // Only the columns outside of the bounds found so far have to be checked in each row
+    unsigned left = width - 1, right = 0;
+    for (unsigned y = top; y <= bottom; ++y) {
+        const uint8_t *row = pixels + y * stride;
+        for (unsigned x = 0; x < left; ++x) {
+            if (row[x * 4 + 3] > 0) {
+                left = x;
+                break;
+            }
+        }
+        for (unsigned x = width - 1; x > right; --x) {
+            if (row[x * 4 + 3] > 0) {
+                right = x;
+                break;
             }
         }
     }
-    // There seems to be some kind of off-by-one error here
-    sf::IntRect bounds(minX, minY, maxX - minX + 1, maxY - minY + 1);
-    return bounds;
+    return sf::IntRect(left, top, right - left + 1, bottom - top + 1);
 }
 
 const sf::Image ResourceManager::cropImage(const sf::Image &image, const sf::IntRect &rect) {
-    sf::Image cropped;
-    cropped.create(rect.width, rect.height);
-    for (unsigned y = 0; y < rect.height; ++y) {
-        for (unsigned x = 0; x < rect.width; ++x) {
-            cropped.setPixel(x, y, image.getPixel(x + rect.left, y + rect.top));
-        }
+    const std::size_t source_stride = static_cast<std::size_t>(image.getSize().x) * 4;
+    const std::size_t row_size = static_cast<std::size_t>(rect.width) * 4;
+    const uint8_t *source = image.getPixelsPtr() + rect.top * source_stride + rect.left * 4;
+    // Copy the rows one at a time, they're contiguous in both images
+    std::vector<uint8_t> pixels(row_size * rect.height);
+    for (int y = 0; y < rect.height; ++y) {
+        std::memcpy(pixels.data() + y * row_size, source + y * source_stride, row_size);
     }
+    sf::Image cropped;
+    cropped.create(rect.width, rect.height, pixels.data());
     return cropped;
 }
 
-std::vector<sf::Image> ResourceManager::splitTexture(const sf::Texture& source_texture, int frame_width, int frame_height) {
+std::vector<sf::Image> ResourceManager::splitTexture(const sf::Image& source_image, int frame_width, int frame_height) {
     std::vector<sf::Image> frame_images;
     // Calculate the number of frames
-    int frame_count = source_texture.getSize().x / frame_width;
-    // Convert the source texture to image for processing
-    sf::Image source_image = source_texture.copyToImage();
+    int frame_count = source_image.getSize().x / frame_width;
     for (int i = 0; i < frame_count; ++i) {
         sf::Image frame_image;
         frame_image.create(frame_width, frame_height);
@@ -294,12 +817,12 @@ std::vector<sf::Image> ResourceManager::splitTexture(const sf::Texture& source_t
     return frame_images;
 }
 
-std::vector<sf::IntRect> ResourceManager::getRects(const sf::Texture &texture) {
+std::vector<sf::IntRect> ResourceManager::getRects(const sf::Image &image) {
     // TODO: Consider something more flexible in the future
     // For now, assume that the texture is a horizontal strip of frames
     std::vector<sf::IntRect> rects;
-    int width = texture.getSize().x;
-    int height = texture.getSize().y;
+    int width = image.getSize().x;
+    int height = image.getSize().y;
     int frame_count = width / height;
     for (int i = 0; i < frame_count; i++) {
         rects.push_back(sf::IntRect(i * height, 0, height, height));
@@ -311,7 +834,7 @@ void ResourceManager::loadAnimation(const std::filesystem::path &path, const std
     // Check if animation is already loaded
     if (!hasAnimation(registry_name)) {
         // Get the texture for the animation
-        const sf::Texture &texture = getTexture(registry_name);
+        const sf::Image &image = getImage(registry_name);
         // // Split the texture into frames
         // std::vector<sf::Image> frames = splitTexture(*texture, texture->getSize().y, texture->getSize().y);
         // // Store each frame in the sprite textures map
@@ -326,13 +849,13 @@ void ResourceManager::loadAnimation(const std::filesystem::path &path, const std
         //     textures[frame_name] = &frame_texture;
         //     sprite_rects[frame_name] = frame_rect;
         // }
-        std::vector<sf::IntRect> frame_rects = getRects(texture);
+        std::vector<sf::IntRect> frame_rects = getRects(image);
         // Load the frame rate from the animation file
-        std::ifstream file(path);
-        nlohmann::json json = nlohmann::json::parse(file);
+        nlohmann::json json = loadJson(path);
         int frame_rate = json["frame_rate"];
         std::cout << "Loaded animation: " << registry_name << " (" << frame_rects.size() << " frames, " << frame_rate << " fps)" << std::endl;
-        animations.insert({registry_name, Animation(frame_rects, frame_rate)});
+        animations[registerTexture(registry_name).index] = AnimationClipId{static_cast<uint32_t>(animation_clips.size())};
+        animation_clips.emplace_back(frame_rects, frame_rate);
     } else {
         std::cout << "Animation already loaded: " << registry_name << std::endl;
     }
@@ -340,19 +863,18 @@ void ResourceManager::loadAnimation(const std::filesystem::path &path, const std
 
 void ResourceManager::loadVariations(const std::filesystem::path &path, const std::string &registry_name) {
     // Check if variations are already loaded
-    if (!hasVariations(registry_name)) {
+    if (!hasVariations(getTextureId(registry_name))) {
         // Get the texture for the variations
-        const sf::Texture &texture = getTexture(registry_name);
-        std::vector<sf::IntRect> variation_rects = getRects(texture);
+        const sf::Image &image = getImage(registry_name);
+        std::vector<sf::IntRect> variation_rects = getRects(image);
         // Load the weightings from the variations file
-        std::ifstream file(path);
-        nlohmann::json json = nlohmann::json::parse(file);
+        nlohmann::json json = loadJson(path);
         std::vector<int> weights;
         for (auto& variation : json["variations"]) {
             weights.push_back(variation["weight"]);
         }
         std::cout << "Loaded variations: " << registry_name << " (" << variation_rects.size() << " variations)" << std::endl;
-        variations.insert({registry_name, std::make_shared<WeightedTexture>(variation_rects, weights)});
+        variations[registerTexture(registry_name).index] = std::make_shared<WeightedTexture>(variation_rects, weights);
     } else {
         std::cout << "Variations already loaded: " << registry_name << std::endl;
     }
@@ -360,26 +882,27 @@ void ResourceManager::loadVariations(const std::filesystem::path &path, const st
 
 void ResourceManager::loadConnectedTexture(const std::filesystem::path &path, const std::string &registry_name) {
     // Check if connected texture is already loaded
-    if (!hasConnectedTexture(registry_name)) {
+    if (getConnectedTextureId(registry_name) == INVALID_TEXTURE_ID) {
         // Get the texture for the connected texture
-        sf::Texture texture;
+        DecodedImage decoded_image;
         // Load the texture from the file (we already know it exists)
-        texture.loadFromFile(path.string());
+        takeDecodedImage(path, decoded_image);
+        const sf::Image &image = decoded_image.image;
         /**
-         * Note that the TEXTURE is stored at registry_name + "_connected", but the
-         * CONNECTED TEXTURE is stored at registry_name. This makes it a lot easier
-         * to check if e.g. a tile has a connected texture, and also easier to retrieve it
-         * since we don't have to getConnectedTexture(registry_name + "_connected"), but
-         * can just use getConnectedTexture(registry_name).
+         * Note that both the TEXTURE and the CONNECTED TEXTURE are stored at
+         * registry_name + "_connected", so they share an id. That id is what
+         * getConnectedTextureId(registry_name) returns, so e.g. a tile can look it
+         * up once and then get both the quad and the connected texture from it.
         */
-        setTexture(registry_name + "_connected", texture, sf::IntRect(0, 0, texture.getSize().x, texture.getSize().y));
+        setTexture(registry_name + "_connected", image, sf::IntRect(0, 0, image.getSize().x, image.getSize().y));
+        TextureId id = registerTexture(registry_name + "_connected");
         std::shared_ptr<connected_textures::ConnectedTexture> connected_texture;
         if (path.string().find(CONNECTED_TEXTURE_FENCE_EXTENSION) != std::string::npos) {
-            connected_texture = std::make_shared<connected_textures::FenceTexture>(texture.getSize());
+            connected_texture = std::make_shared<connected_textures::FenceTexture>(image.getSize());
         } else if (path.string().find(CONNECTED_TEXTURE_BLOB_EXTENSION) != std::string::npos) {
-            connected_texture = std::make_shared<connected_textures::BlobTexture>(texture.getSize());
+            connected_texture = std::make_shared<connected_textures::BlobTexture>(image.getSize());
         }
-        connected_textures.insert({registry_name + "_connected", connected_texture});
+        connected_textures[id.index] = connected_texture;
         std::cout << "Loaded connected texture: " << registry_name + "_connected" << std::endl;
     } else {
         std::cout << "Connected texture already loaded: " << registry_name << std::endl;
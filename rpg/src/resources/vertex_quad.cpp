@@ -5,11 +5,10 @@ namespace resources {
 
 VertexQuad::VertexQuad(const sf::Vector2f &position, const sf::IntRect &texture_rect, float scale) {
     this->scale = scale;
-    this->vertices.reserve(4);
-    this->vertices.push_back(sf::Vertex(sf::Vector2f(position.x, position.y), sf::Vector2f(texture_rect.left, texture_rect.top)));
-    this->vertices.push_back(sf::Vertex(sf::Vector2f(position.x + texture_rect.width * scale, position.y), sf::Vector2f(texture_rect.left + texture_rect.width, texture_rect.top)));
-    this->vertices.push_back(sf::Vertex(sf::Vector2f(position.x + texture_rect.width * scale, position.y + texture_rect.height * scale), sf::Vector2f(texture_rect.left + texture_rect.width, texture_rect.top + texture_rect.height)));
-    this->vertices.push_back(sf::Vertex(sf::Vector2f(position.x, position.y + texture_rect.height * scale), sf::Vector2f(texture_rect.left, texture_rect.top + texture_rect.height)));
+    this->vertices[0] = sf::Vertex(sf::Vector2f(position.x, position.y), sf::Vector2f(texture_rect.left, texture_rect.top));
+    this->vertices[1] = sf::Vertex(sf::Vector2f(position.x + texture_rect.width * scale, position.y), sf::Vector2f(texture_rect.left + texture_rect.width, texture_rect.top));
+    this->vertices[2] = sf::Vertex(sf::Vector2f(position.x + texture_rect.width * scale, position.y + texture_rect.height * scale), sf::Vector2f(texture_rect.left + texture_rect.width, texture_rect.top + texture_rect.height));
+    this->vertices[3] = sf::Vertex(sf::Vector2f(position.x, position.y + texture_rect.height * scale), sf::Vector2f(texture_rect.left, texture_rect.top + texture_rect.height));
 }
 
 void VertexQuad::move(const sf::Vector2f &offset) {
@@ -0,0 +1,186 @@
+#include "resources/virtual_file_system.hpp"
+#include "resources/asset_pack.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+
+namespace rpg {
+namespace resources {
+
+void VirtualFileSystem::mount(const std::filesystem::path &root) {
+    this->root = root.lexically_normal();
+    // "resources/" would make every path relative to it start with ".."
+    if (this->root.filename().empty()) {
+        this->root = this->root.parent_path();
+    }
+    archive.reset();
+    entries.clear();
+    folders.clear();
+    if (std::filesystem::is_directory(this->root)) {
+        indexFolder();
+    } else if (std::filesystem::is_regular_file(this->root)) {
+        indexArchive();
+    } else {
+        throw std::runtime_error("VirtualFileSystem::" + std::string(__func__) + "(): No resources at " + root.string());
+    }
+    std::cout << "Mounted " << (isArchive() ? "archive " : "folder ") << this->root << ": " << entries.size() << " files" << std::endl;
+}
+
+bool VirtualFileSystem::exists(const std::filesystem::path &path) const {
+    std::string key;
+    return getKey(path, key) && entries.find(key) != entries.end();
+}
+
+bool VirtualFileSystem::isDirectory(const std::filesystem::path &path) const {
+    std::string key;
+    return getKey(path, key) && folders.find(key) != folders.end();
+}
+
+std::vector<std::filesystem::path> VirtualFileSystem::list(const std::filesystem::path &path) const {
+    std::vector<std::filesystem::path> paths;
+    std::string key;
+    if (!getKey(path, key)) {
+        return paths;
+    }
+    auto folder = folders.find(key);
+    if (folder == folders.end()) {
+        return paths;
+    }
+    for (const std::string &file_key : folder->second) {
+        paths.push_back(root / file_key);
+    }
+    return paths;
+}
+
+VirtualFileSystem::File VirtualFileSystem::open(const std::filesystem::path &path) const {
+    std::string key;
+    auto entry = getKey(path, key) ? entries.find(key) : entries.end();
+    if (entry == entries.end()) {
+        throw std::runtime_error("VirtualFileSystem::" + std::string(__func__) + "(): File not found: " + path.string());
+    }
+    if (!isArchive()) {
+        // Mapped when it's opened, so a file that changed on disk is read again
+        return map(root / key);
+    }
+    File file;
+    file.mapping = archive;
+    file.data = archive->getData() + entry->second.offset;
+    file.size = entry->second.size;
+    return file;
+}
+
+VirtualFileSystem::File VirtualFileSystem::map(const std::filesystem::path &path) {
+    File file;
+    file.mapping = std::make_shared<const MappedFile>(path);
+    file.data = file.mapping->getData();
+    file.size = file.mapping->getSize();
+    return file;
+}
+
+void VirtualFileSystem::writeArchive(const std::filesystem::path &folder, const std::filesystem::path &archive_path) {
+    std::vector<std::string> keys;
+    for (auto it = std::filesystem::recursive_directory_iterator(folder); it != std::filesystem::recursive_directory_iterator(); ++it) {
+        std::string filename = it->path().filename().string();
+        if (it->is_directory() && !filename.empty() && filename[0] == '.') {
+            it.disable_recursion_pending();
+            continue;
+        }
+        if (!it->is_regular_file() || (std::filesystem::exists(archive_path) && std::filesystem::equivalent(it->path(), archive_path))) {
+            continue;
+        }
+        keys.push_back(it->path().lexically_relative(folder).generic_string());
+    }
+    // Directory iterators don't have a fixed order
+    std::sort(keys.begin(), keys.end());
+    std::vector<File> files;
+    for (const std::string &key : keys) {
+        files.push_back(map(folder / key));
+    }
+    AssetPackWriter writer(ARCHIVE_MAGIC, ARCHIVE_VERSION);
+    writer.write<uint32_t>(keys.size());
+    uint64_t offset = 0;
+    for (std::size_t i = 0; i < keys.size(); i++) {
+        writer.writeString(keys[i]);
+        writer.write<uint64_t>(offset);
+        writer.write<uint64_t>(files[i].size);
+        offset = (offset + files[i].size + ARCHIVE_ALIGNMENT - 1) / ARCHIVE_ALIGNMENT * ARCHIVE_ALIGNMENT;
+    }
+    writer.align(ARCHIVE_ALIGNMENT);
+    for (const File &file : files) {
+        writer.writeBytes(file.data, file.size);
+        writer.align(ARCHIVE_ALIGNMENT);
+    }
+    writer.save(archive_path);
+    std::cout << "Wrote " << keys.size() << " files to " << archive_path << std::endl;
+}
+
+bool VirtualFileSystem::getKey(const std::filesystem::path &path, std::string &key) const {
+    std::filesystem::path relative = path.lexically_normal().lexically_relative(root);
+    if (relative.empty() || *relative.begin() == "..") {
+        return false;
+    }
+    key = relative.generic_string();
+    // The root itself, or a folder written with a trailing separator
+    if (key == ".") {
+        key.clear();
+    } else if (key.back() == '/') {
+        key.pop_back();
+    }
+    return true;
+}
+
+void VirtualFileSystem::indexFolder() {
+    for (const auto &file : std::filesystem::recursive_directory_iterator(root)) {
+        if (file.is_regular_file()) {
+            std::string key = file.path().lexically_relative(root).generic_string();
+            entries[key] = Entry{0, static_cast<std::size_t>(file.file_size())};
+            addToFolder(key);
+        }
+    }
+    for (auto &[folder, keys] : folders) {
+        std::sort(keys.begin(), keys.end());
+    }
+}
+
+void VirtualFileSystem::indexArchive() {
+    File file = map(root);
+    AssetPackReader reader(file, root.string(), ARCHIVE_MAGIC, ARCHIVE_VERSION);
+    uint32_t count = reader.read<uint32_t>();
+    std::vector<std::pair<std::string, Entry>> toc;
+    toc.reserve(count);
+    for (uint32_t i = 0; i < count; i++) {
+        std::string key = reader.readString();
+        Entry entry;
+        entry.offset = reader.read<uint64_t>();
+        entry.size = reader.read<uint64_t>();
+        toc.emplace_back(std::move(key), entry);
+    }
+    reader.align(ARCHIVE_ALIGNMENT);
+    std::size_t data_start = reader.getOffset();
+    for (auto &[key, entry] : toc) {
+        entry.offset += data_start;
+        if (entry.offset > file.size || entry.size > file.size - entry.offset) {
+            throw std::runtime_error("VirtualFileSystem::" + std::string(__func__) + "(): " + key + " is past the end of " + root.string());
+        }
+        entries[key] = entry;
+        // The table of contents is sorted already, see writeArchive()
+        addToFolder(key);
+    }
+    archive = file.mapping;
+}
+
+void VirtualFileSystem::addToFolder(const std::string &key) {
+    std::size_t separator = key.rfind('/');
+    std::string folder = separator == std::string::npos ? "" : key.substr(0, separator);
+    folders[folder].push_back(key);
+    // Parent folders count as folders too, even if they only hold other folders
+    while (separator != std::string::npos) {
+        separator = folder.rfind('/');
+        folder = separator == std::string::npos ? "" : folder.substr(0, separator);
+        folders[folder];
+    }
+}
+
+} // namespace resources
+} // namespace rpg
@@ -32,6 +32,10 @@ WeightedTexture::WeightedTexture(const std::vector<sf::IntRect> &variations, con
 }
 
 sf::IntRect WeightedTexture::getRandomRect() const {
+    return variations[getRandomIndex()];
+}
+
+int WeightedTexture::getRandomIndex() const {
     // Generate a random number between 0 and the sum of the weights.
     int random = rand() % total_weight;
     // Find the index of the texture that corresponds to the random number.
@@ -44,7 +48,7 @@ sf::IntRect WeightedTexture::getRandomRect() const {
         }
         index++;
     }
-    return variations[index];
+    return index;
 }
 
 sf::IntRect WeightedTexture::getRect(int index) const {
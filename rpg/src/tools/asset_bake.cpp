@@ -0,0 +1,50 @@
+#include <iostream>
+#include <filesystem>
+
+#include "resources/game_registry.hpp"
+#include "resources/virtual_file_system.hpp"
+#include "engine/job_system.hpp"
+
+using namespace rpg::resources;
+using rpg::engine::JobSystem;
+
+/**
+ * Bakes the resources folder into an asset pack (see asset_pack.hpp), so the
+ * game doesn't have to decode, crop and pack every texture at startup.
+ *
+ * Usage: rpg_assetbake [output path] [archive path]
+ * The pack is written to the resources folder by default, which is where the
+ * game looks for it. The game ignores it again once any of the resources
+ * change, until the assets are baked again. Each page of the texture atlas is also saved next to the
+ * pack as a png, which is handy for checking what ended up where.
+ * If an archive path is given, the whole resources folder (including the pack,
+ * if it was written there) is also written to a single archive, which the game
+ * can load instead of the folder (see VirtualFileSystem).
+*/
+int main(int argc, char const *argv[]) {
+    std::filesystem::path output_path = argc > 1 ? std::filesystem::path(argv[1]) : GameRegistry::getPackPath();
+    // The images are decoded on the job system
+    JobSystem::getInstance().start();
+    try {
+        // Always load from the source files, even if there's an old pack or cache lying around
+        GameRegistry::setUsePack(false);
+        GameRegistry::setUseCache(false);
+        GameRegistry &game_registry = GameRegistry::getInstance();
+        game_registry.savePack(output_path);
+        for (std::size_t page = 0; page < game_registry.getTextureAtlasPageCount(); page++) {
+            std::filesystem::path atlas_path = output_path;
+            atlas_path.replace_extension(".atlas" + std::to_string(page) + ".png");
+            game_registry.getTextureAtlas(page).copyToImage().saveToFile(atlas_path.string());
+        }
+        if (argc > 2) {
+            VirtualFileSystem::writeArchive(GameRegistry::getResourcesFolder(), argv[2]);
+        }
+    } catch (const std::exception &exception) {
+        std::cerr << "Failed to bake assets: " << exception.what() << std::endl;
+        JobSystem::getInstance().stop();
+        return 1;
+    }
+    JobSystem::getInstance().stop();
+    std::cout << "Baked assets to " << output_path << std::endl;
+    return 0;
+}
@@ -0,0 +1,381 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <vector>
+#include <iterator>
+#include <new>
+#include <cstdlib>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <algorithm>
+#include <cstring>
+#include <random>
+
+#include "resources/game_registry.hpp"
+#include "resources/resource_manager.hpp"
+#include "engine/entity.hpp"
+#include "engine/ecs/registry.hpp"
+#include "engine/ecs/systems.hpp"
+#include "engine/ecs/draw_order.hpp"
+#include "engine/ecs/tick_scheduler.hpp"
+#include "engine/constants.hpp"
+#include "engine/job_system.hpp"
+#include "engine/world.hpp"
+
+using namespace rpg;
+using resources::GameRegistry;
+using engine::JobSystem;
+
+/**
+ * Microbenchmarks for the hot paths of the game, so changes to them can be
+ * measured rather than guessed at.
+ *
+ * Usage: rpg_bench [resources folder]
+ * The resources are loaded the same way the game loads them, so run
+ * rpg_assetbake first to benchmark with the asset pack.
+*/
+
+/**
+ * @brief The number of allocations made so far, see the operator new below.
+*/
+static std::atomic<std::size_t> allocation_count{0};
+
+void* operator new(std::size_t size) {
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    if (void *pointer = std::malloc(size == 0 ? 1 : size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * @brief Get the time since a point in nanoseconds.
+*/
+static double elapsedNanoseconds(Clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+}
+
+/**
+ * @brief The getPixel() based ResourceManager::getMinimumRect() from before
+ * it read the pixel buffer directly, kept for comparison.
+*/
+static sf::IntRect getMinimumRectByPixel(const sf::Image &image) {
+    int minX = image.getSize().x, minY = image.getSize().y, maxX = 0, maxY = 0;
+    for (unsigned y = 0; y < image.getSize().y; ++y) {
+        for (unsigned x = 0; x < image.getSize().x; ++x) {
+            sf::Color pixel = image.getPixel(x, y);
+            if (pixel.a > 0) {
+                minX = std::min(minX, static_cast<int>(x));
+                minY = std::min(minY, static_cast<int>(y));
+                maxX = std::max(maxX, static_cast<int>(x));
+                maxY = std::max(maxY, static_cast<int>(y));
+            }
+        }
+    }
+    return sf::IntRect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+}
+
+/**
+ * @brief The getPixel()/setPixel() based ResourceManager::cropImage(), kept for comparison.
+*/
+static sf::Image cropImageByPixel(const sf::Image &image, const sf::IntRect &rect) {
+    sf::Image cropped;
+    cropped.create(rect.width, rect.height);
+    for (int y = 0; y < rect.height; ++y) {
+        for (int x = 0; x < rect.width; ++x) {
+            cropped.setPixel(x, y, image.getPixel(x + rect.left, y + rect.top));
+        }
+    }
+    return cropped;
+}
+
+/**
+ * @brief Time trimming and cropping 2048x2048 sheets, against the old implementations.
+ * The sheets are transparent apart from a grid of opaque frames, with a
+ * different margin around the grid in each, so both the early outs of the new
+ * getMinimumRect() and its worst case are covered.
+*/
+static void benchImageTrimming() {
+    constexpr unsigned SIZE = 2048;
+    constexpr int REPEATS = 5;
+    struct Sheet {
+        const char *name;
+        unsigned margin;
+    };
+    const Sheet sheets[] = {{"full", 0}, {"margin 64", 64}, {"margin 512", 512}, {"single pixel", SIZE / 2}};
+    for (const Sheet &sheet : sheets) {
+        sf::Image image;
+        image.create(SIZE, SIZE, sf::Color::Transparent);
+        // Frames of 32x32 pixels with a transparent border of 4 pixels, like a sprite sheet
+        for (unsigned y = sheet.margin; y < SIZE - sheet.margin; y++) {
+            for (unsigned x = sheet.margin; x < SIZE - sheet.margin; x++) {
+                if (x % 32 >= 4 && y % 32 >= 4) {
+                    image.setPixel(x, y, sf::Color::White);
+                }
+            }
+        }
+        if (sheet.margin == SIZE / 2) {
+            image.setPixel(SIZE / 2, SIZE / 2, sf::Color::White);
+        }
+        double old_rect_time = 0.0, new_rect_time = 0.0, old_crop_time = 0.0, new_crop_time = 0.0;
+        sf::IntRect old_rect, new_rect;
+        bool same = true;
+        for (int i = 0; i < REPEATS; i++) {
+            Clock::time_point start = Clock::now();
+            old_rect = getMinimumRectByPixel(image);
+            old_rect_time += elapsedNanoseconds(start);
+            start = Clock::now();
+            new_rect = resources::ResourceManager::getMinimumRect(image);
+            new_rect_time += elapsedNanoseconds(start);
+            start = Clock::now();
+            sf::Image old_cropped = cropImageByPixel(image, new_rect);
+            old_crop_time += elapsedNanoseconds(start);
+            start = Clock::now();
+            sf::Image new_cropped = resources::ResourceManager::cropImage(image, new_rect);
+            new_crop_time += elapsedNanoseconds(start);
+            same = same && old_rect == new_rect && old_cropped.getSize() == new_cropped.getSize() &&
+                std::memcmp(old_cropped.getPixelsPtr(), new_cropped.getPixelsPtr(), new_rect.width * new_rect.height * 4) == 0;
+        }
+        std::cout << "Trimming a " << SIZE << "x" << SIZE << " sheet (" << sheet.name << ")" << (same ? "" : ", results differ!") << std::endl
+                  << "  getMinimumRect: " << old_rect_time / REPEATS / 1e6 << " ms -> " << new_rect_time / REPEATS / 1e6 << " ms" << std::endl
+                  << "  cropImage: " << old_crop_time / REPEATS / 1e6 << " ms -> " << new_crop_time / REPEATS / 1e6 << " ms" << std::endl;
+    }
+}
+
+/**
+ * @brief Time Entity::update(), which picks the clip from the animation table
+ * and advances it, and count the allocations it makes (there should be none).
+*/
+static void benchEntityUpdate() {
+    constexpr std::size_t ENTITY_COUNT = 10000;
+    constexpr int TICKS = 120;
+    const GameRegistry::EntityData data = GameRegistry::getInstance().getEntityData("entity.player");
+    // Every facing, plus standing still, so that every slot of the table is used
+    const sf::Vector2f directions[] = {
+        sf::Vector2f(0, 1), sf::Vector2f(0, -1), sf::Vector2f(-1, 0), sf::Vector2f(1, 0),
+        sf::Vector2f(1, 1), sf::Vector2f(0, 0)
+    };
+    std::vector<engine::Entity> entities;
+    entities.reserve(ENTITY_COUNT);
+    for (std::size_t i = 0; i < ENTITY_COUNT; i++) {
+        entities.emplace_back(sf::Vector2f(i % 100, i / 100), data);
+        entities.back().setDirection(directions[i % std::size(directions)]);
+    }
+    // The first update starts the clips
+    for (engine::Entity &entity : entities) {
+        entity.update(engine::constants::SIMULATION_TICK);
+    }
+    std::size_t allocations = allocation_count.load();
+    Clock::time_point start = Clock::now();
+    for (int tick = 0; tick < TICKS; tick++) {
+        // Switch direction every so often, so that the clips change as well
+        if (tick % 30 == 0) {
+            for (std::size_t i = 0; i < entities.size(); i++) {
+                entities[i].setDirection(directions[(i + tick / 30) % std::size(directions)]);
+            }
+        }
+        for (engine::Entity &entity : entities) {
+            entity.update(engine::constants::SIMULATION_TICK);
+        }
+    }
+    double elapsed = elapsedNanoseconds(start);
+    allocations = allocation_count.load() - allocations;
+    std::cout << "Entity::update: " << elapsed / (TICKS * ENTITY_COUNT) << " ns per entity, "
+              << allocations << " allocations in " << TICKS << " ticks of " << ENTITY_COUNT << " entities" << std::endl;
+}
+
+/**
+ * @brief Time the animation batch with 50k animated entities: advancing the
+ * animations (every tick), moving the quads, and sorting the entities and
+ * appending the visible quads in draw order (every frame).
+*/
+static void benchAnimationBatch() {
+    constexpr std::size_t ENTITY_COUNT = 50000;
+    constexpr int FRAMES = 120;
+    GameRegistry &game_registry = GameRegistry::getInstance();
+    const GameRegistry::EntityData data = game_registry.getEntityData("entity.player");
+    const resources::ResourceManager &resource_manager = game_registry.getResourceManager();
+    if (data.animations.empty()) {
+        throw std::runtime_error(std::string(__func__) + "(): The player has no animations");
+    }
+    std::vector<resources::AnimationClipId> clip_ids;
+    for (const auto &[key, clip_id] : data.animations) {
+        clip_ids.push_back(clip_id);
+    }
+    engine::ecs::Registry registry;
+    registry.reserve(ENTITY_COUNT);
+    engine::ecs::AnimationBatch &animation_batch = registry.getAnimationBatch();
+    animation_batch.reserve(ENTITY_COUNT);
+    // Spread out over a square, and all in view, which is the worst case for drawing
+    const float side = std::ceil(std::sqrt((float) ENTITY_COUNT));
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> random_offset(0.0f, 1.0f);
+    std::vector<sf::Vector2f> velocities;
+    for (std::size_t i = 0; i < ENTITY_COUNT; i++) {
+        engine::ecs::EntityHandle entity = registry.create();
+        sf::Vector2f position(i % (std::size_t) side, i / (std::size_t) side);
+        // Offset so that the rows don't all have the same y
+        position.y += random_offset(random);
+        registry.getStore<engine::ecs::Position>().add(entity, {position, position});
+        // Up to 3 tiles per second along each axis
+        velocities.emplace_back((random_offset(random) - 0.5f) * 6.0f, (random_offset(random) - 0.5f) * 6.0f);
+        resources::AnimationClipId clip_id = clip_ids[i % clip_ids.size()];
+        animation_batch.add(entity, clip_id, resource_manager.getAnimation(clip_id), i % 2 == 0);
+    }
+    const sf::FloatRect viewport(0.0f, 0.0f, side, side);
+    engine::ecs::DrawOrder draw_order;
+    sf::VertexArray vertex_array(sf::PrimitiveType::Quads);
+    double update_time = 0.0, positions_time = 0.0, sort_time = 0.0, append_time = 0.0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        // Move every entity a little, like a tick would, so the draw order has to be fixed up
+        std::vector<engine::ecs::Position> &positions = registry.getStore<engine::ecs::Position>().getComponents();
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            positions[i].previous = positions[i].value;
+            positions[i].value += velocities[i] * engine::constants::SIMULATION_TICK;
+        }
+        Clock::time_point start = Clock::now();
+        animation_batch.update(engine::constants::SIMULATION_TICK);
+        update_time += elapsedNanoseconds(start);
+        start = Clock::now();
+        animation_batch.updatePositions(registry.getStore<engine::ecs::Position>(), 0.5f);
+        positions_time += elapsedNanoseconds(start);
+        start = Clock::now();
+        draw_order.update(registry, viewport, 0.5f);
+        sort_time += elapsedNanoseconds(start);
+        start = Clock::now();
+        vertex_array.clear();
+        for (const engine::ecs::DrawOrder::Entry &entry : draw_order.getVisibleEntries()) {
+            engine::ecs::DrawOrder::appendQuad(registry, entry, 0.5f, vertex_array);
+        }
+        append_time += elapsedNanoseconds(start);
+    }
+    std::cout << "AnimationBatch (" << ENTITY_COUNT << " entities):" << std::endl
+              << "  update: " << update_time / FRAMES / 1e6 << " ms" << std::endl
+              << "  updatePositions: " << positions_time / FRAMES / 1e6 << " ms" << std::endl
+              << "  DrawOrder::update: " << sort_time / FRAMES / 1e6 << " ms (" << draw_order.getVisibleEntries().size() << " visible)" << std::endl
+              << "  DrawOrder::appendQuad: " << append_time / FRAMES / 1e6 << " ms" << std::endl;
+}
+
+/**
+ * @brief Time the tick scheduler with 100k entities spread over the 500x500
+ * world and the focus in the middle, so most entities are frozen, as they
+ * would be in a large world.
+*/
+static void benchTickScheduler() {
+    constexpr std::size_t ENTITY_COUNT = 100000;
+    constexpr int TICKS = 240;
+    engine::ecs::Registry registry;
+    registry.reserve(ENTITY_COUNT);
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> distribution(0.0f, 500.0f);
+    for (std::size_t i = 0; i < ENTITY_COUNT; i++) {
+        sf::Vector2f position(distribution(random), distribution(random));
+        registry.getStore<engine::ecs::Position>().add(registry.create(), {position, position});
+    }
+    engine::ecs::TickScheduler tick_scheduler;
+    const sf::Vector2f focus(250.0f, 250.0f);
+    // The first ticks classify the new entities
+    for (int tick = 0; tick < engine::constants::LOD_RECLASSIFY_TICKS; tick++) {
+        tick_scheduler.schedule(registry, focus, engine::constants::SIMULATION_TICK);
+    }
+    std::size_t update_count = 0;
+    Clock::time_point start = Clock::now();
+    for (int tick = 0; tick < TICKS; tick++) {
+        tick_scheduler.schedule(registry, focus, engine::constants::SIMULATION_TICK);
+        update_count += tick_scheduler.getUpdates().size();
+    }
+    double elapsed = elapsedNanoseconds(start);
+    std::cout << "TickScheduler (" << ENTITY_COUNT << " entities, "
+              << tick_scheduler.getCount(engine::ecs::TickScheduler::FROZEN) << " frozen): "
+              << elapsed / TICKS / 1e6 << " ms per tick, " << (double) update_count / TICKS << " updates per tick" << std::endl;
+}
+
+/**
+ * @brief Time path queries on the same 500x500 world the game generates, both
+ * across the whole world and between nearby tiles. Each set is run twice, since
+ * the first run also fills the path finder's caches.
+*/
+static void benchPathFinding() {
+    constexpr std::size_t QUERY_COUNT = 1000;
+    constexpr int NEARBY_RANGE = 32;
+    const sf::Vector2i dimensions(500, 500);
+    engine::World world(dimensions, 1337);
+    const engine::ChunkMap &chunk_map = world.getChunkMap();
+    std::mt19937 random(1337);
+    std::uniform_int_distribution<int> x_distribution(0, dimensions.x - 1);
+    std::uniform_int_distribution<int> y_distribution(0, dimensions.y - 1);
+    std::uniform_int_distribution<int> offset_distribution(-NEARBY_RANGE, NEARBY_RANGE);
+    auto randomWalkableTile = [&]() {
+        sf::Vector2i tile;
+        do {
+            tile = sf::Vector2i(x_distribution(random), y_distribution(random));
+        } while (chunk_map.isSolid(tile.x, tile.y));
+        return tile;
+    };
+    std::vector<std::pair<sf::Vector2i, sf::Vector2i>> far_queries, near_queries;
+    far_queries.reserve(QUERY_COUNT);
+    near_queries.reserve(QUERY_COUNT);
+    for (std::size_t i = 0; i < QUERY_COUNT; i++) {
+        far_queries.emplace_back(randomWalkableTile(), randomWalkableTile());
+        sf::Vector2i start = randomWalkableTile();
+        sf::Vector2i goal;
+        do {
+            goal = start + sf::Vector2i(offset_distribution(random), offset_distribution(random));
+        } while (chunk_map.isSolid(goal.x, goal.y));
+        near_queries.emplace_back(start, goal);
+    }
+    std::vector<sf::Vector2i> path;
+    auto run = [&](const char *name, const std::vector<std::pair<sf::Vector2i, sf::Vector2i>> &queries) {
+        double total_time = 0.0, worst_time = 0.0;
+        std::size_t found = 0;
+        for (const auto &[start, goal] : queries) {
+            Clock::time_point query_start = Clock::now();
+            found += world.findPath(start, goal, path);
+            double elapsed = elapsedNanoseconds(query_start);
+            total_time += elapsed;
+            worst_time = std::max(worst_time, elapsed);
+        }
+        std::cout << "  " << name << ": " << queries.size() / (total_time / 1e9) << " queries/s, "
+                  << total_time / queries.size() / 1e6 << " ms mean, " << worst_time / 1e6 << " ms worst ("
+                  << found << "/" << queries.size() << " found)" << std::endl;
+    };
+    std::cout << "PathFinder (" << dimensions.x << "x" << dimensions.y << " world):" << std::endl;
+    run("far, cold", far_queries);
+    run("far, warm", far_queries);
+    run("near, cold", near_queries);
+    run("near, warm", near_queries);
+}
+
+int main(int argc, char const *argv[]) {
+    if (argc > 1) {
+        GameRegistry::setResourcesFolder(argv[1]);
+    }
+    std::cout << std::fixed << std::setprecision(2);
+    JobSystem::getInstance().start();
+    try {
+        benchImageTrimming();
+        GameRegistry::getInstance();
+        benchEntityUpdate();
+        benchAnimationBatch();
+        benchTickScheduler();
+        benchPathFinding();
+    } catch (const std::exception &exception) {
+        std::cerr << "Benchmark failed: " << exception.what() << std::endl;
+        JobSystem::getInstance().stop();
+        return 1;
+    }
+    JobSystem::getInstance().stop();
+    return 0;
+}